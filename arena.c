@@ -0,0 +1,108 @@
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_CHUNK_SIZE 65536
+#define ARENA_ALIGNMENT sizeof(void*)      // Every object the compiler allocates holds pointers or ints
+
+// Arena Chunk
+struct ArenaChunk {
+    ArenaChunk* next;
+    size_t used;
+    size_t size;
+    _Alignas(max_align_t) unsigned char data[];
+};
+
+// Starts an empty arena (no memory is reserved until the first allocation)
+void initArena(Arena* arena) {
+    arena->chunks = NULL;
+    arena->spare = NULL;
+    arena->allocations = 0;
+    arena->bytesUsed = 0;
+    arena->bytesReserved = 0;
+    arena->chunkCount = 0;
+}
+
+// Carves size bytes from the current chunk, opening a new one when full.
+// Chunk starts are aligned, so padding object sizes keeps objects aligned
+static void* carve(Arena* arena, size_t size) {
+    ArenaChunk* chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < size) {
+        size_t chunkSize = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+        if (arena->spare && chunkSize == ARENA_CHUNK_SIZE) {
+            chunk = arena->spare;
+            arena->spare = chunk->next;
+        } else {
+            chunk = (ArenaChunk*) malloc(sizeof(ArenaChunk) + chunkSize);
+            if (!chunk) {
+                fprintf(stderr, "\nOut of memory.\n");
+                exit(1);
+            }
+        }
+        chunk->next = arena->chunks;
+        chunk->used = 0;
+        chunk->size = chunkSize;
+        arena->chunks = chunk;
+        arena->bytesReserved += chunkSize;
+        arena->chunkCount++;
+    }
+
+    void* p = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->allocations++;
+    arena->bytesUsed += size;
+    return p;
+}
+
+// Allocates an object aligned for any type
+void* arenaAlloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    return carve(arena, size);
+}
+
+// Allocates character data with no alignment padding.
+// Do not mix with arenaAlloc on the same arena
+void* arenaAllocBytes(Arena* arena, size_t size) {
+    return carve(arena, size);
+}
+
+// Frees a list of chunks
+static void freeChunks(ArenaChunk* chunk) {
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+// Drops every object but keeps the regular sized chunks for the next
+// allocations, so a long running process stops calling malloc once warm
+void resetArena(Arena* arena) {
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        if (chunk->size == ARENA_CHUNK_SIZE) {
+            chunk->next = arena->spare;
+            arena->spare = chunk;
+        } else {
+            free(chunk);
+        }
+        chunk = next;
+    }
+
+    ArenaChunk* spare = arena->spare;
+    initArena(arena);
+    arena->spare = spare;
+}
+
+// Frees every chunk of the arena
+void releaseArena(Arena* arena) {
+    freeChunks(arena->chunks);
+    freeChunks(arena->spare);
+    initArena(arena);
+}
+
+// Prints object count and memory usage of the arena
+void printArenaStats(const Arena* arena, const char* name, FILE* out) {
+    fprintf(out, "%s arena: %zu objects, %zu bytes used, %zu bytes reserved in %d chunks\n",
+        name, arena->allocations, arena->bytesUsed, arena->bytesReserved, arena->chunkCount);
+}
@@ -0,0 +1,30 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// Region allocator: objects are carved sequentially from large
+// chunks and released all at once with releaseArena.
+
+typedef struct ArenaChunk ArenaChunk;
+
+// Arena Struct
+typedef struct Arena {
+    ArenaChunk* chunks;
+    ArenaChunk* spare;      // Chunks kept by resetArena for reuse
+    size_t allocations;     // Objects carved from the arena
+    size_t bytesUsed;       // Bytes handed out, including alignment
+    size_t bytesReserved;   // Bytes obtained from malloc for chunks in use
+    int chunkCount;
+} Arena;
+
+// Arena functions
+void initArena(Arena* arena);
+void* arenaAlloc(Arena* arena, size_t size);
+void* arenaAllocBytes(Arena* arena, size_t size);
+void resetArena(Arena* arena);
+void releaseArena(Arena* arena);
+void printArenaStats(const Arena* arena, const char* name, FILE* out);
+
+#endif
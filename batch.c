@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "batch.h"
+#include "compilation.h"
+#include "rascal_inline.h"
+
+// One file of the batch
+typedef struct BatchJob {
+    char *input;
+    char *output;
+    CompileStatus status;
+} BatchJob;
+
+// Work shared by the worker threads
+typedef struct BatchPool {
+    BatchJob *jobs;
+    int count;
+    int next;                   // Next job to hand out
+    int failed;
+    CompileCache *cache;        // NULL when not caching
+    int optimize;
+    int inlineLimit;
+    pthread_mutex_t lock;       // Guards next, failed and stdout
+} BatchPool;
+
+// Output path for an input: "name.ras" becomes "name.mep"
+static char *defaultOutputPath(const char *input) {
+    size_t len = strlen(input);
+    if (len > 4 && strcmp(input + len - 4, ".ras") == 0) len -= 4;
+
+    char *output = (char *) malloc(len + 5);
+    memcpy(output, input, len);
+    strcpy(output + len, ".mep");
+    return output;
+}
+
+// Appends a job, growing the job array as needed
+static void addJob(BatchJob **jobs, int *count, int *capacity, const char *input, const char *output) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        *jobs = (BatchJob *) realloc(*jobs, *capacity * sizeof(BatchJob));
+    }
+
+    BatchJob *job = &(*jobs)[(*count)++];
+    job->input = strdup(input);
+    job->output = output ? strdup(output) : defaultOutputPath(input);
+    job->status = COMPILE_OK;
+}
+
+// Reads a manifest: one "<rascal_file> [<mepa_object>]" per line,
+// blank lines and lines starting with '#' are ignored
+static int readManifest(const char *path, BatchJob **jobs, int *count, int *capacity) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        char *input = strtok(line, " \t\r\n");
+        if (!input || input[0] == '#') continue;
+        char *output = strtok(NULL, " \t\r\n");
+        addJob(jobs, count, capacity, input, output);
+    }
+
+    fclose(f);
+    return 1;
+}
+
+// Compiles one job, printing its status and messages in one piece
+static void runJob(BatchPool *pool, BatchJob *job) {
+    char *messages = NULL;
+    size_t size = 0;
+    FILE *log = open_memstream(&messages, &size);
+
+    // Without memory for the messages they go straight to stderr
+    job->status = compileFile(job->input, job->output, pool->cache, pool->optimize, pool->inlineLimit,
+                              log ? log : stderr);
+    if (log) fclose(log);
+
+    // Messages are written for a terminal: trim their surrounding blank lines
+    char *text = messages ? messages : "";
+    while (*text == '\n') text++;
+    size_t len = strlen(text);
+    while (len > 0 && text[len - 1] == '\n') text[--len] = '\0';
+
+    pthread_mutex_lock(&pool->lock);
+    if (job->status == COMPILE_OK) {
+        printf("[ ok ] %s -> %s\n", job->input, job->output);
+    } else {
+        pool->failed++;
+        printf("[fail] %s: %s\n", job->input, compileStatusName(job->status));
+        if (len > 0) printf("%s\n", text);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    free(messages);
+}
+
+// Worker thread: takes jobs until none is left
+static void *worker(void *arg) {
+    BatchPool *pool = (BatchPool *) arg;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        int i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (i >= pool->count) break;
+        runJob(pool, &pool->jobs[i]);
+    }
+
+    return NULL;
+}
+
+static void printBatchUsage(void) {
+    fprintf(stderr, "\nUsage: rascalc --batch [-j <workers>] [-O<level>] [--inline-limit <nodes>] [--cache-dir <dir>] (<rascal_file>... | --manifest <list_file>)\n");
+}
+
+// Batch mode entry point (argv[0] is "--batch")
+int batchMain(int argc, char *argv[]) {
+    BatchJob *jobs = NULL;
+    int count = 0, capacity = 0;
+    int workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    const char *cacheDir = NULL;
+    int optimize = 0;
+    int inlineLimit = INLINE_LIMIT_DEFAULT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (parseOptimizeOption(argv[i]) >= 0) {
+            optimize = parseOptimizeOption(argv[i]);
+        } else if (strcmp(argv[i], "--inline-limit") == 0 && i + 1 < argc) {
+            inlineLimit = parseInlineLimit(argv[++i]);
+            if (inlineLimit < 0) {
+                fprintf(stderr, "\nInvalid inline limit: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc) {
+            if (!readManifest(argv[++i], &jobs, &count, &capacity)) {
+                fprintf(stderr, "\nError opening manifest file: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "\nUnknown option: %s\n", argv[i]);
+            printBatchUsage();
+            return 1;
+        } else {
+            addJob(&jobs, &count, &capacity, argv[i], NULL);
+        }
+    }
+
+    if (count == 0) {
+        printBatchUsage();
+        return 1;
+    }
+    if (workers < 1) workers = 1;
+    if (workers > count) workers = count;
+
+    CompileCache cache;
+    if (cacheDir && !openCompileCache(&cache, cacheDir)) {
+        fprintf(stderr, "\nError opening cache directory: %s\n", cacheDir);
+        return 1;
+    }
+
+    BatchPool pool;
+    pool.jobs = jobs;
+    pool.count = count;
+    pool.next = 0;
+    pool.failed = 0;
+    pool.cache = cacheDir ? &cache : NULL;
+    pool.optimize = optimize;
+    pool.inlineLimit = inlineLimit;
+    pthread_mutex_init(&pool.lock, NULL);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t *threads = (pthread_t *) malloc(workers * sizeof(pthread_t));
+    for (int i = 0; i < workers; i++)
+        pthread_create(&threads[i], NULL, worker, &pool);
+    for (int i = 0; i < workers; i++)
+        pthread_join(threads[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("\nBatch: %d files, %d compiled, %d failed (%d workers, %.3f s)\n",
+        count, count - pool.failed, pool.failed, workers, seconds);
+    if (pool.cache) {
+        closeCompileCache(&cache);
+        printCacheStats(&cache, stdout);
+    }
+
+    int failed = pool.failed;
+    pthread_mutex_destroy(&pool.lock);
+    free(threads);
+    for (int i = 0; i < count; i++) {
+        free(jobs[i].input);
+        free(jobs[i].output);
+    }
+    free(jobs);
+
+    return failed > 0 ? 1 : 0;
+}
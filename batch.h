@@ -0,0 +1,9 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// Batch mode: compiles many Rascal files concurrently
+//   rascalc --batch [-j <workers>] [-O<level>] [--inline-limit <nodes>] [--cache-dir <dir>] <rascal_file>...
+//   rascalc --batch [-j <workers>] [-O<level>] [--inline-limit <nodes>] [--cache-dir <dir>] --manifest <list_file>
+int batchMain(int argc, char *argv[]);
+
+#endif
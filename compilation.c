@@ -0,0 +1,180 @@
+#include <stdarg.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compilation.h"
+#include "semantics.h"
+#include "rascal_opt.h"
+#include "rascal_inline.h"
+#include "rascal_mepa.h"
+
+// Starts an empty compilation
+void initCompilation(Compilation* comp) {
+    comp->source.text = NULL;
+    comp->source.length = 0;
+    comp->source.mapLength = 0;
+    initArena(&comp->astArena);
+    initInternTable(&comp->identifiers);
+    comp->astRoot = NULL;
+    comp->flatAst = 0;
+    initFlatAst(&comp->flat);
+    comp->lexicalErrors = 0;
+    comp->log = stdout;
+    comp->diagnostics = NULL;
+    comp->diagnosticCount = 0;
+    comp->diagnosticCapacity = 0;
+    memset(&comp->stats, 0, sizeof(comp->stats));
+    comp->optimize = 0;
+    comp->inlineLimit = INLINE_LIMIT_DEFAULT;
+}
+
+// Frees the diagnostics list
+static void freeDiagnostics(Compilation* comp) {
+    for (int i = 0; i < comp->diagnosticCount; i++)
+        free(comp->diagnostics[i].message);
+    free(comp->diagnostics);
+    comp->diagnostics = NULL;
+    comp->diagnosticCount = 0;
+    comp->diagnosticCapacity = 0;
+}
+
+// Prepares the compilation for another program, keeping its memory
+void resetCompilation(Compilation* comp) {
+    resetArena(&comp->astArena);
+    comp->astRoot = NULL;
+    clearFlatAst(&comp->flat);
+    clearInternTable(&comp->identifiers);
+    closeSourceBuffer(&comp->source);
+    comp->lexicalErrors = 0;
+    freeDiagnostics(comp);
+    memset(&comp->stats, 0, sizeof(comp->stats));
+}
+
+// Releases the AST, the identifiers and the source text
+void freeCompilation(Compilation* comp) {
+    freeAstRoot(&comp->astArena);
+    comp->astRoot = NULL;
+    freeFlatAst(&comp->flat);
+    freeInternTable(&comp->identifiers);
+    closeSourceBuffer(&comp->source);
+    freeDiagnostics(comp);
+}
+
+// Records a diagnostic and prints it to the log in the rascalc format
+void reportError(Compilation* comp, RascalPhase phase, int line, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    char* message = (char*) malloc(length + 1);
+    va_start(args, format);
+    vsnprintf(message, length + 1, format, args);
+    va_end(args);
+
+    if (comp->diagnosticCount == comp->diagnosticCapacity) {
+        comp->diagnosticCapacity = comp->diagnosticCapacity ? comp->diagnosticCapacity * 2 : 8;
+        comp->diagnostics = (RascalDiagnostic*) realloc(comp->diagnostics,
+            comp->diagnosticCapacity * sizeof(RascalDiagnostic));
+    }
+    RascalDiagnostic* d = &comp->diagnostics[comp->diagnosticCount++];
+    d->phase = phase;
+    d->line = line;
+    d->message = message;
+
+    if (!comp->log) return;
+    switch (phase) {
+        case RASCAL_LEXICAL_ERROR:
+            fprintf(comp->log, "\nLexical error in line %d: %s\n", line, message);
+            break;
+        case RASCAL_SYNTAX_ERROR:
+            fprintf(comp->log, "\nSyntatic error in line %d: %s\n", line, message);
+            break;
+        case RASCAL_SEMANTIC_ERROR:
+            fprintf(comp->log, "\nSemantic error: %s\n", message);
+            break;
+        case RASCAL_WARNING:
+            fprintf(comp->log, "\nWarning: %s\n", message);
+            break;
+        default:
+            fprintf(comp->log, "\n%s\n", message);
+            break;
+    }
+}
+
+// Reads an "-O<level>" option: returns the level, or -1 when arg is not one
+int parseOptimizeOption(const char* arg) {
+    if (strncmp(arg, "-O", 2) != 0 || arg[2] < '0' || arg[2] > '0' + OPT_LEVEL_MAX || arg[3]) return -1;
+    return arg[2] - '0';
+}
+
+// Reads an --inline-limit value: returns the limit, or -1 when arg is
+// not a non-negative integer
+int parseInlineLimit(const char* arg) {
+    char* end;
+    long limit = strtol(arg, &end, 10);
+    if (end == arg || *end || limit < 0 || limit > INT_MAX) return -1;
+    return (int) limit;
+}
+
+// Options that change the generated code, for the compile cache key
+// (buffer must hold 32 bytes)
+const char* codeOptionsKey(char* buffer, int optimize, int inlineLimit, int binary) {
+    snprintf(buffer, 32, "-O%d inline=%d%s", optimize, inlineLimit, binary ? " binary" : "");
+    return buffer;
+}
+
+// Looks the source up in the cache (may be NULL), leaving its key in key
+static int fetchCached(CompileCache* cache, const Compilation* comp, char* key, const char* outputPath) {
+    if (!cache) return 0;
+    char options[32];
+    cacheKey(key, codeOptionsKey(options, comp->optimize, comp->inlineLimit, 0), comp->source.text, comp->source.length);
+    return cacheFetch(cache, key, outputPath);
+}
+
+// Runs every phase on one file without printing the AST, unless the
+// cache (may be NULL) already holds its code.
+// Messages go to log, so concurrent compilations do not interleave
+CompileStatus compileFile(const char* inputPath, const char* outputPath, CompileCache* cache,
+                          int optimize, int inlineLimit, FILE* log) {
+    Compilation comp;
+    initCompilation(&comp);
+    comp.log = log;
+    comp.optimize = optimize;
+    comp.inlineLimit = inlineLimit;
+
+    CompileStatus status = COMPILE_OK;
+    char key[CACHE_KEY_SIZE];
+
+    if (!openSourceBuffer(&comp.source, inputPath)) {
+        reportError(&comp, RASCAL_INPUT_ERROR, 0, "Error opening rascal file: %s", inputPath);
+        status = COMPILE_INPUT_ERROR;
+    } else if (fetchCached(cache, &comp, key, outputPath)) {
+        if (log) fprintf(log, "\nMEPA code loaded from cache: %s", outputPath);
+    } else if (parseSource(&comp) != 0 || comp.astRoot == NULL || comp.lexicalErrors > 0) {
+        status = COMPILE_PARSE_ERROR;
+    } else if (semanticCheck(&comp) != 0) {
+        status = COMPILE_SEMANTIC_ERROR;
+    } else {
+        optimizeProgram(&comp);
+        if (generateCode(&comp, outputPath, MEPA_TEXT) != 0)
+            status = COMPILE_OUTPUT_ERROR;
+        else if (cache)
+            cacheStore(cache, key, outputPath);
+    }
+
+    freeCompilation(&comp);
+    return status;
+}
+
+// Describes a compilation outcome
+const char* compileStatusName(CompileStatus status) {
+    switch (status) {
+        case COMPILE_OK:             return "ok";
+        case COMPILE_INPUT_ERROR:    return "input error";
+        case COMPILE_PARSE_ERROR:    return "parse error";
+        case COMPILE_SEMANTIC_ERROR: return "semantic error";
+        case COMPILE_OUTPUT_ERROR:   return "output error";
+    }
+    return "unknown";
+}
@@ -0,0 +1,56 @@
+#ifndef COMPILATION_H
+#define COMPILATION_H
+
+#include <stdio.h>
+#include "rascal.h"
+#include "arena.h"
+#include "intern_table.h"
+#include "rascal_ast.h"
+#include "rascal_flat.h"
+#include "rascal_source.h"
+#include "compile_cache.h"
+#include "compile_stats.h"
+
+// State of one compilation: everything the lexer, parser and later
+// passes share lives here instead of in process globals, so separate
+// compilations can run concurrently.
+typedef struct Compilation {
+    SourceBuffer source;
+    Arena astArena;             // Every node of the Abstract Syntax Tree
+    InternTable identifiers;
+    Program* astRoot;
+    int flatAst;                // Build the flat layout (rascalc --flat-ast) instead of astRoot
+    FlatAst flat;
+    int lexicalErrors;
+    FILE* log;                  // Where error and progress messages go, NULL for none
+    RascalDiagnostic* diagnostics;
+    int diagnosticCount;
+    int diagnosticCapacity;
+    CompileStats stats;         // Counters and timings for rascalc --stats
+    int optimize;               // Optimization level, 0 to OPT_LEVEL_MAX
+    int inlineLimit;            // Largest subroutine body inlined at -O2, 0 for none
+} Compilation;
+
+// Outcome of compiling one file
+typedef enum {
+    COMPILE_OK,
+    COMPILE_INPUT_ERROR,
+    COMPILE_PARSE_ERROR,
+    COMPILE_SEMANTIC_ERROR,
+    COMPILE_OUTPUT_ERROR
+} CompileStatus;
+
+// Compilation functions
+void initCompilation(Compilation* comp);
+int parseSource(Compilation* comp);
+void resetCompilation(Compilation* comp);
+void freeCompilation(Compilation* comp);
+void reportError(Compilation* comp, RascalPhase phase, int line, const char* format, ...);
+CompileStatus compileFile(const char* inputPath, const char* outputPath, CompileCache* cache,
+                          int optimize, int inlineLimit, FILE* log);
+int parseOptimizeOption(const char* arg);
+int parseInlineLimit(const char* arg);
+const char* codeOptionsKey(char* buffer, int optimize, int inlineLimit, int binary);
+const char* compileStatusName(CompileStatus status);
+
+#endif
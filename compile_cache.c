@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#include "compile_cache.h"
+#include "rascal.h"
+#include "sha256.h"
+
+// Path of an entry, or of its directory when name is NULL
+static char* entryPath(const CompileCache* cache, const char* key, const char* name) {
+    size_t size = strlen(cache->dir) + CACHE_KEY_SIZE + 32;
+    char* path = (char*) malloc(size);
+    if (name)
+        snprintf(path, size, "%s/%.2s/%s", cache->dir, key, name);
+    else
+        snprintf(path, size, "%s/%.2s", cache->dir, key);
+    return path;
+}
+
+// Copies a whole file between descriptors
+static int copyFile(int from, int to) {
+    char buffer[65536];
+    ssize_t n;
+    while ((n = read(from, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t done = 0; done < n; ) {
+            ssize_t w = write(to, buffer + done, n - done);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0) return 0;
+            done += w;
+        }
+    }
+    return n == 0;
+}
+
+static void countEvent(CompileCache* cache, int* counter) {
+    pthread_mutex_lock(&cache->lock);
+    (*counter)++;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// Opens (creating if needed) a cache directory
+int openCompileCache(CompileCache* cache, const char* dir) {
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) return 0;
+
+    struct stat st;
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) return 0;
+
+    cache->dir = strdup(dir);
+    cache->hits = cache->misses = cache->stores = 0;
+    cache->totalHits = cache->totalMisses = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+    return 1;
+}
+
+// Key of a compilation: anything that changes the output must be hashed
+void cacheKey(char key[CACHE_KEY_SIZE], const char* options, const char* text, size_t length) {
+    static const char hexDigits[] = "0123456789abcdef";
+    static const char version[] = "rascalc " RASCAL_VERSION;
+
+    Sha256 h;
+    sha256Init(&h);
+    sha256Update(&h, version, sizeof(version));
+    sha256Update(&h, options, strlen(options) + 1);
+    sha256Update(&h, text, length);
+
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    sha256Final(&h, digest);
+    for (int i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        key[2 * i] = hexDigits[digest[i] >> 4];
+        key[2 * i + 1] = hexDigits[digest[i] & 15];
+    }
+    key[CACHE_KEY_SIZE - 1] = '\0';
+}
+
+// Writes the cached MEPA code of key to outputPath: returns 1 on a hit
+int cacheFetch(CompileCache* cache, const char* key, const char* outputPath) {
+    char name[CACHE_KEY_SIZE + 4];
+    snprintf(name, sizeof(name), "%s.mep", key + 2);
+    char* path = entryPath(cache, key, name);
+    int fd = open(path, O_RDONLY);
+    free(path);
+
+    // MEPA code is never empty: an empty entry was cut short by a crash
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        if (fd >= 0) close(fd);
+        countEvent(cache, &cache->misses);
+        return 0;
+    }
+
+    int out = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    int ok = out >= 0 && copyFile(fd, out);
+    if (out >= 0 && close(out) != 0) ok = 0;
+    close(fd);
+
+    countEvent(cache, ok ? &cache->hits : &cache->misses);
+    return ok;
+}
+
+// Stores the MEPA code in mepaPath under key: returns 1 when stored
+int cacheStore(CompileCache* cache, const char* key, const char* mepaPath) {
+    char* dir = entryPath(cache, key, NULL);
+    char* temp = entryPath(cache, key, ".tmp-XXXXXX");
+    char name[CACHE_KEY_SIZE + 4];
+    snprintf(name, sizeof(name), "%s.mep", key + 2);
+    char* path = entryPath(cache, key, name);
+
+    int ok = 0;
+    int from = open(mepaPath, O_RDONLY);
+    if (from >= 0 && (mkdir(dir, 0777) == 0 || errno == EEXIST)) {
+        int to = mkstemp(temp);
+        if (to >= 0) {
+            // mkstemp creates the file private to its owner
+            ok = fchmod(to, 0644) == 0 && copyFile(from, to);
+            if (close(to) != 0) ok = 0;
+            if (ok) ok = rename(temp, path) == 0;
+            if (!ok) unlink(temp);
+        }
+    }
+    if (from >= 0) close(from);
+
+    if (ok) countEvent(cache, &cache->stores);
+    free(dir);
+    free(temp);
+    free(path);
+    return ok;
+}
+
+// Adds this process' counters to the stats file and releases the cache
+void closeCompileCache(CompileCache* cache) {
+    size_t size = strlen(cache->dir) + 8;
+    char* path = (char*) malloc(size);
+    snprintf(path, size, "%s/stats", cache->dir);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (fd >= 0 && flock(fd, LOCK_EX) == 0) {
+        char text[128];
+        ssize_t n = pread(fd, text, sizeof(text) - 1, 0);
+        text[n > 0 ? n : 0] = '\0';
+
+        long hits = 0, misses = 0;
+        sscanf(text, "hits %ld misses %ld", &hits, &misses);
+        cache->totalHits = hits + cache->hits;
+        cache->totalMisses = misses + cache->misses;
+
+        int length = snprintf(text, sizeof(text), "hits %ld misses %ld\n", cache->totalHits, cache->totalMisses);
+        if (ftruncate(fd, 0) == 0 && pwrite(fd, text, length, 0) != length)
+            cache->totalHits = cache->totalMisses = 0;
+        flock(fd, LOCK_UN);
+    }
+    if (fd >= 0) close(fd);
+    free(path);
+
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->dir);
+    cache->dir = NULL;
+}
+
+// Prints the counters of this process and, once closed, of every run
+void printCacheStats(const CompileCache* cache, FILE* out) {
+    fprintf(out, "\nCache: %d hits, %d misses, %d stored", cache->hits, cache->misses, cache->stores);
+    long total = cache->totalHits + cache->totalMisses;
+    if (total > 0)
+        fprintf(out, " (all runs: %ld hits, %ld misses, %.1f%% hit rate)",
+            cache->totalHits, cache->totalMisses, 100.0 * cache->totalHits / total);
+    fprintf(out, "\n");
+}
@@ -0,0 +1,37 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// On-disk compile cache: the MEPA code of every successful compilation,
+// stored under the SHA-256 of the compiler version, its options and the
+// source text. Entries are written to a temporary file and renamed into
+// place, so concurrent rascalc processes only ever see whole entries.
+//
+// Layout: <dir>/<first 2 hex digits>/<remaining 62>.mep, plus <dir>/stats
+// holding the hit and miss totals of every run (updated under flock).
+
+#define CACHE_KEY_SIZE 65       // Hex digest and NUL
+
+// Cache Struct
+typedef struct CompileCache {
+    char* dir;
+    int hits;                   // Counters of this process
+    int misses;
+    int stores;
+    long totalHits;             // Counters of every run, once closed
+    long totalMisses;
+    pthread_mutex_t lock;       // Guards the counters
+} CompileCache;
+
+// Cache functions
+int openCompileCache(CompileCache* cache, const char* dir);
+void cacheKey(char key[CACHE_KEY_SIZE], const char* options, const char* text, size_t length);
+int cacheFetch(CompileCache* cache, const char* key, const char* outputPath);
+int cacheStore(CompileCache* cache, const char* key, const char* mepaPath);
+void closeCompileCache(CompileCache* cache);
+void printCacheStats(const CompileCache* cache, FILE* out);
+
+#endif
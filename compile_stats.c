@@ -0,0 +1,249 @@
+#include <string.h>
+#include <sys/resource.h>
+#include "compile_stats.h"
+
+static const char* phaseNames[PHASE_COUNT] = {"parse", "print", "semantic", "optimize", "codegen"};
+static const char* commandNames[Write + 1] = {"assign", "proc_call", "conditional", "loop", "read", "write"};
+static const char* expressionNames[FuncCall + 1] = {"binary", "unary", "variable", "const_int", "const_bool", "func_call"};
+
+static double seconds(const struct timespec* t) {
+    return t->tv_sec + t->tv_nsec / 1e9;
+}
+
+// - Timing -------------------------------
+
+void startPhase(PhaseTimer* timer) {
+    clock_gettime(CLOCK_MONOTONIC, &timer->wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timer->cpu);
+}
+
+void endPhase(CompileStats* stats, StatsPhase phase, const PhaseTimer* timer) {
+    struct timespec wall, cpu;
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+
+    stats->phases[phase].wall += seconds(&wall) - seconds(&timer->wall);
+    stats->phases[phase].cpu += seconds(&cpu) - seconds(&timer->cpu);
+    stats->phases[phase].ran = 1;
+}
+
+// - AST Counting -------------------------
+
+static void countExpressions(CompileStats* stats, const Expression* e) {
+    for (; e; e = e->next) {
+        stats->expressions[e->type]++;
+        switch (e->type) {
+            case Binary:
+                countExpressions(stats, e->exprU.binExpr.left);
+                countExpressions(stats, e->exprU.binExpr.right);
+                break;
+            case Unary:
+                countExpressions(stats, e->exprU.unyExpr.right);
+                break;
+            case FuncCall:
+                countExpressions(stats, e->exprU.funCallExpr.expressionList);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void countCommands(CompileStats* stats, const Command* c) {
+    for (; c; c = c->next) {
+        stats->commands[c->type]++;
+        switch (c->type) {
+            case Assign:
+                countExpressions(stats, c->cmdU.assignInfo.expression);
+                break;
+            case ProcCall:
+                countExpressions(stats, c->cmdU.procCallInfo.expressionList);
+                break;
+            case Conditional:
+                countExpressions(stats, c->cmdU.condInfo.condExpression);
+                countCommands(stats, c->cmdU.condInfo.cmdIf);
+                countCommands(stats, c->cmdU.condInfo.cmdElse);
+                break;
+            case Loop:
+                countExpressions(stats, c->cmdU.loopInfo.loopExpression);
+                countCommands(stats, c->cmdU.loopInfo.cmdLoop);
+                break;
+            case Read:
+                for (const IdentifierList* id = c->cmdU.readInfo.identifiers; id; id = id->next)
+                    stats->identifierLists++;
+                break;
+            case Write:
+                countExpressions(stats, c->cmdU.writeInfo.expressionList);
+                break;
+        }
+    }
+}
+
+static void countVarDeclarations(CompileStats* stats, const VarDeclaration* vd) {
+    for (; vd; vd = vd->next) stats->varDeclarations++;
+}
+
+// Counts the nodes of a parsed program by kind
+void countAstNodes(CompileStats* stats, const Program* program) {
+    if (!program || !program->block) return;
+
+    const Block* b = program->block;
+    countVarDeclarations(stats, b->varDeclarations);
+    for (const SubRotDeclaration* sd = b->subRotDeclarations; sd; sd = sd->next) {
+        stats->subRotDeclarations++;
+        const SubRotBlock* sb;
+        if (sd->type == Proc) {
+            countVarDeclarations(stats, sd->subrotU.procInfo.formParams);
+            sb = sd->subrotU.procInfo.subRotBlock;
+        } else {
+            countVarDeclarations(stats, sd->subrotU.funcInfo.formParams);
+            sb = sd->subrotU.funcInfo.subRotBlock;
+        }
+        if (sb) {
+            countVarDeclarations(stats, sb->varDeclarations);
+            countCommands(stats, sb->commands);
+        }
+    }
+    countCommands(stats, b->commandList);
+}
+
+// Counts the rows of a flat program by kind. Read targets are Var rows,
+// counted as read identifiers like the linked ones
+void countFlatAstNodes(CompileStats* stats, const FlatAst* ast) {
+    if (!ast->complete) return;
+
+    for (uint32_t c = 1; c < ast->commands.count; c++) {
+        stats->commands[ast->commands.kind[c]]++;
+        if (ast->commands.kind[c] != Read) continue;
+        for (FlatIndex e = ast->commands.a[c]; e; e = ast->expressions.next[e]) {
+            stats->identifierLists++;
+            stats->expressions[Var]--;
+        }
+    }
+    for (uint32_t e = 1; e < ast->expressions.count; e++) stats->expressions[ast->expressions.kind[e]]++;
+    stats->varDeclarations += ast->variableCount - 1;
+    stats->subRotDeclarations += ast->subroutineCount - 1;
+}
+
+// - MEPA Counting ------------------------
+
+void countInstruction(CompileStats* stats, MepaOpcode op) {
+    stats->instructions++;
+    stats->mnemonics[op]++;
+}
+
+// - Optimization Counting ----------------
+
+void countOptimization(CompileStats* stats, const char* name, long count) {
+    if (count == 0) return;
+    for (int i = 0; i < stats->optimizationCount; i++) {
+        if (strcmp(stats->optimizations[i].name, name) == 0) {
+            stats->optimizations[i].count += count;
+            return;
+        }
+    }
+    if (stats->optimizationCount == OPTIMIZATION_COUNTER_MAX) return;
+    stats->optimizations[stats->optimizationCount].name = name;
+    stats->optimizations[stats->optimizationCount].count = count;
+    stats->optimizationCount++;
+}
+
+// - Symbol Table Counting ----------------
+
+void addSymbolTableStats(CompileStats* stats, const SymbolTable* table) {
+    stats->lookups += table->lookup_calls;
+    stats->lookupSteps += table->lookup_steps;
+    stats->installs += table->install_calls;
+}
+
+// - Report -------------------------------
+
+static long peakMemoryKb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+static long sumCounts(const long* counts, int n) {
+    long total = 0;
+    for (int i = 0; i < n; i++) total += counts[i];
+    return total;
+}
+
+static void printJson(const CompileStats* stats, FILE* out) {
+    fprintf(out, "{\n  \"phases\": {");
+    int first = 1;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        if (!stats->phases[p].ran) continue;
+        fprintf(out, "%s\n    \"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}", first ? "" : ",",
+            phaseNames[p], stats->phases[p].wall * 1e3, stats->phases[p].cpu * 1e3);
+        first = 0;
+    }
+    fprintf(out, "\n  },\n  \"tokens\": %ld,\n", stats->tokens);
+
+    fprintf(out, "  \"ast\": {\n    \"commands\": {");
+    for (int i = 0; i <= Write; i++)
+        fprintf(out, "%s\"%s\": %ld", i ? ", " : "", commandNames[i], stats->commands[i]);
+    fprintf(out, "},\n    \"expressions\": {");
+    for (int i = 0; i <= FuncCall; i++)
+        fprintf(out, "%s\"%s\": %ld", i ? ", " : "", expressionNames[i], stats->expressions[i]);
+    fprintf(out, "},\n    \"var_declarations\": %ld,\n    \"subroutines\": %ld,\n    \"read_identifiers\": %ld,\n    \"bytes\": %ld\n  },\n",
+        stats->varDeclarations, stats->subRotDeclarations, stats->identifierLists, stats->astBytes);
+
+    fprintf(out, "  \"symbols\": {\"lookups\": %ld, \"lookup_steps\": %ld, \"avg_chain\": %.2f, \"installs\": %ld},\n",
+        stats->lookups, stats->lookupSteps, stats->lookups ? (double) stats->lookupSteps / stats->lookups : 0.0,
+        stats->installs);
+
+    fprintf(out, "  \"mepa\": {\"instructions\": %ld, \"labels\": %ld, \"by_mnemonic\": {",
+        stats->instructions, stats->labels);
+    first = 1;
+    for (int i = 0; i < MEPA_OPCODE_COUNT; i++) {
+        if (!stats->mnemonics[i]) continue;
+        fprintf(out, "%s\"%s\": %ld", first ? "" : ", ", mepaMnemonic(i), stats->mnemonics[i]);
+        first = 0;
+    }
+    fprintf(out, "}},\n  \"optimizations\": {");
+    for (int i = 0; i < stats->optimizationCount; i++)
+        fprintf(out, "%s\"%s\": %ld", i ? ", " : "", stats->optimizations[i].name, stats->optimizations[i].count);
+    fprintf(out, "},\n  \"peak_rss_kb\": %ld\n}\n", peakMemoryKb());
+}
+
+static void printText(const CompileStats* stats, FILE* out) {
+    fprintf(out, "\nCompilation stats:\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        if (!stats->phases[p].ran) continue;
+        fprintf(out, "  %-9s %10.3f ms wall %10.3f ms cpu\n", phaseNames[p],
+            stats->phases[p].wall * 1e3, stats->phases[p].cpu * 1e3);
+    }
+    fprintf(out, "  Tokens: %ld\n", stats->tokens);
+
+    fprintf(out, "  Commands: %ld (", sumCounts(stats->commands, Write + 1));
+    for (int i = 0; i <= Write; i++)
+        fprintf(out, "%s%s %ld", i ? ", " : "", commandNames[i], stats->commands[i]);
+    fprintf(out, ")\n  Expressions: %ld (", sumCounts(stats->expressions, FuncCall + 1));
+    for (int i = 0; i <= FuncCall; i++)
+        fprintf(out, "%s%s %ld", i ? ", " : "", expressionNames[i], stats->expressions[i]);
+    fprintf(out, ")\n  Declarations: %ld variables, %ld subroutines\n  AST: %ld bytes\n",
+        stats->varDeclarations, stats->subRotDeclarations, stats->astBytes);
+
+    fprintf(out, "  Symbol table: %ld lookups probing %.2f slots on average, %ld installs\n",
+        stats->lookups, stats->lookups ? (double) stats->lookupSteps / stats->lookups : 0.0, stats->installs);
+
+    fprintf(out, "  MEPA: %ld instructions, %ld labels\n   ", stats->instructions, stats->labels);
+    for (int i = 0; i < MEPA_OPCODE_COUNT; i++)
+        if (stats->mnemonics[i]) fprintf(out, " %s %ld", mepaMnemonic(i), stats->mnemonics[i]);
+    if (stats->optimizationCount) {
+        fprintf(out, "\n  Optimizations:");
+        for (int i = 0; i < stats->optimizationCount; i++)
+            fprintf(out, "%s %s %ld", i ? "," : "", stats->optimizations[i].name, stats->optimizations[i].count);
+    }
+    fprintf(out, "\n  Peak memory: %ld KiB\n", peakMemoryKb());
+}
+
+// Prints the report as text or as a JSON object
+void printCompileStats(const CompileStats* stats, int json, FILE* out) {
+    if (json)
+        printJson(stats, out);
+    else
+        printText(stats, out);
+}
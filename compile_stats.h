@@ -0,0 +1,82 @@
+#ifndef COMPILE_STATS_H
+#define COMPILE_STATS_H
+
+#include <stdio.h>
+#include <time.h>
+#include "rascal_ast.h"
+#include "rascal_flat.h"
+#include "symbol_table.h"
+#include "mepa_emit.h"
+
+// Counters and timings of one compilation, reported by rascalc --stats
+
+// Timed phases
+typedef enum {
+    PHASE_PARSE,
+    PHASE_PRINT,
+    PHASE_SEMANTIC,
+    PHASE_OPTIMIZE,
+    PHASE_CODEGEN,
+    PHASE_COUNT
+} StatsPhase;
+
+// Phase Timing Struct
+typedef struct PhaseTime {
+    double wall;                // Seconds
+    double cpu;                 // Seconds of this thread
+    int ran;
+} PhaseTime;
+
+// Running timer of a phase
+typedef struct PhaseTimer {
+    struct timespec wall;
+    struct timespec cpu;
+} PhaseTimer;
+
+#define OPTIMIZATION_COUNTER_MAX 48
+
+// Times an optimization (a pass or one of its rules) applied
+typedef struct OptimizationCounter {
+    const char* name;           // Static string
+    long count;
+} OptimizationCounter;
+
+// Stats Struct
+typedef struct CompileStats {
+    PhaseTime phases[PHASE_COUNT];
+    long tokens;
+
+    // AST nodes by kind (indexed by cmdType and exprType)
+    long commands[Write + 1];
+    long expressions[FuncCall + 1];
+    long varDeclarations;
+    long subRotDeclarations;
+    long identifierLists;
+    long astBytes;              // Memory the tree takes, in either layout
+
+    // Symbol tables of every pass
+    long lookups;
+    long lookupSteps;           // Slots probed by lookup()
+    long installs;
+
+    // MEPA output
+    long instructions;
+    long labels;
+    long mnemonics[MEPA_OPCODE_COUNT];
+
+    // Optimizations, in the order they first applied
+    OptimizationCounter optimizations[OPTIMIZATION_COUNTER_MAX];
+    int optimizationCount;
+} CompileStats;
+
+// Stats functions
+void startPhase(PhaseTimer* timer);
+void endPhase(CompileStats* stats, StatsPhase phase, const PhaseTimer* timer);
+void countAstNodes(CompileStats* stats, const Program* program);
+void countFlatAstNodes(CompileStats* stats, const FlatAst* ast);
+void countInstruction(CompileStats* stats, MepaOpcode op);
+void countOptimization(CompileStats* stats, const char* name, long count);
+void addSymbolTableStats(CompileStats* stats, const SymbolTable* table);
+void printCompileStats(const CompileStats* stats, int json, FILE* out);
+
+#endif
@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <string.h>
+#include "intern_table.h"
+
+#define INITIAL_CAPACITY 1024
+
+// Intern Table Slot
+struct InternSlot {
+    char* text;
+    unsigned int hash;
+    int length;
+    unsigned int number;
+};
+
+// FNV-1a hash of the identifier
+static unsigned int hashIdentifier(const char* text, int length) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        h ^= (unsigned char) text[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Copies the identifier into the storage arena
+static char* storeIdentifier(InternTable* table, const char* text, int length) {
+    char* copy = (char*) arenaAllocBytes(&table->storage, (size_t) length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Doubles the slot array, rehashing the stored identifiers
+static void growTable(InternTable* table) {
+    unsigned int newCapacity = table->capacity ? table->capacity * 2 : INITIAL_CAPACITY;
+    InternSlot* newSlots = (InternSlot*) calloc(newCapacity, sizeof(InternSlot));
+
+    for (unsigned int i = 0; i < table->capacity; i++) {
+        if (!table->slots[i].text) continue;
+        unsigned int j = table->slots[i].hash & (newCapacity - 1);
+        while (newSlots[j].text) j = (j + 1) & (newCapacity - 1);
+        newSlots[j] = table->slots[i];
+    }
+
+    free(table->slots);
+    table->slots = newSlots;
+    table->capacity = newCapacity;
+}
+
+// Starts an empty intern table
+void initInternTable(InternTable* table) {
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+    table->names = NULL;
+    table->nameCapacity = 0;
+    initArena(&table->storage);
+}
+
+// Returns the number of the identifier, storing it on first sight
+unsigned int internIdentifierNumber(InternTable* table, const char* text, int length) {
+    if ((table->count + 1) * 10 > table->capacity * 7) growTable(table);
+    if (table->count == table->nameCapacity) {
+        table->nameCapacity = table->nameCapacity ? table->nameCapacity * 2 : INITIAL_CAPACITY;
+        table->names = (char**) realloc(table->names, table->nameCapacity * sizeof(char*));
+    }
+
+    unsigned int h = hashIdentifier(text, length);
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = h & mask;
+
+    while (table->slots[i].text) {
+        InternSlot* slot = &table->slots[i];
+        if (slot->hash == h && slot->length == length && memcmp(slot->text, text, length) == 0)
+            return slot->number;
+        i = (i + 1) & mask;
+    }
+
+    table->slots[i].text = storeIdentifier(table, text, length);
+    table->slots[i].hash = h;
+    table->slots[i].length = length;
+    table->slots[i].number = table->count;
+    table->names[table->count] = table->slots[i].text;
+
+    return table->count++;
+}
+
+// Returns the unique copy of the identifier, storing it on first sight
+char* internIdentifier(InternTable* table, const char* text, int length) {
+    unsigned int number = internIdentifierNumber(table, text, length);
+    return table->names[number];
+}
+
+// Forgets every identifier, keeping the slots and storage for reuse
+void clearInternTable(InternTable* table) {
+    if (table->slots) memset(table->slots, 0, table->capacity * sizeof(InternSlot));
+    table->count = 0;
+    resetArena(&table->storage);
+}
+
+// Releases every interned identifier
+void freeInternTable(InternTable* table) {
+    releaseArena(&table->storage);
+    free(table->slots);
+    free(table->names);
+    initInternTable(table);
+}
+
+// Prints the identifier count and the memory holding them
+void printInternStats(const InternTable* table, FILE* out) {
+    printArenaStats(&table->storage, "Identifier", out);
+}
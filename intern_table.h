@@ -0,0 +1,32 @@
+#ifndef INTERN_TABLE_H
+#define INTERN_TABLE_H
+
+#include <stdio.h>
+#include "arena.h"
+
+// Interned identifiers: each distinct name is stored once, so two
+// identifiers are equal exactly when their pointers are equal. Names
+// are also numbered in order of first sight (the flat AST stores the
+// 32-bit number instead of the pointer).
+
+typedef struct InternSlot InternSlot;
+
+// Intern table (open addressing, linear probing)
+typedef struct InternTable {
+    InternSlot* slots;
+    unsigned int capacity;
+    unsigned int count;
+    char** names;           // Interned identifiers by number
+    unsigned int nameCapacity;
+    Arena storage;          // Characters of the interned identifiers
+} InternTable;
+
+// Intern table functions
+void initInternTable(InternTable* table);
+char* internIdentifier(InternTable* table, const char* text, int length);
+unsigned int internIdentifierNumber(InternTable* table, const char* text, int length);
+void clearInternTable(InternTable* table);
+void freeInternTable(InternTable* table);
+void printInternStats(const InternTable* table, FILE* out);
+
+#endif
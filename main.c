@@ -1,54 +1,221 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 
-#include "rascal_parser.tab.h"
-#include "rascal_ast.h"
+#include "batch.h"
+#include "server.h"
+#include "compilation.h"
 #include "semantics.h"
+#include "rascal_opt.h"
+#include "rascal_inline.h"
 #include "rascal_mepa.h"
+#include "mepa_object.h"
 
-extern int yylineno;
-extern FILE *yyin;
-extern Program *ast_root;
+// Options of a single file compilation
+typedef struct MainOptions {
+    const char *cacheDir;       // NULL when not caching
+    int stats;                  // Print the --stats report
+    int statsJson;
+    MepaFormat format;          // Text or binary object
+    int optimize;               // -O level
+    int inlineLimit;            // --inline-limit
+    int flatAst;                // --flat-ast, -O0 only
+} MainOptions;
 
-int lexical_errors = 0;
+// Prints the --stats report (on stderr, apart from the compiler output)
+// and releases the compilation
+static int finishCompilation(Compilation *comp, const MainOptions *options, int status) {
+    if (options->stats) printCompileStats(&comp->stats, options->statsJson, stderr);
+    freeCompilation(comp);
+    return status;
+}
 
-int main(int argc, char *argv[]) {
-    // Verify arguments
-    if (argc < 3) {
-        fprintf(stderr, "\nUsage: %s <rascal_file> <mepa_object>\n", argv[0]);
-        return 1;
+// Compiles one file printing every phase, unless the cache (may be NULL)
+// already holds its code
+static int compileVerbose(const char *input, const char *output, CompileCache *cache, const MainOptions *options) {
+    Compilation comp;
+    initCompilation(&comp);
+    comp.optimize = options->optimize;
+    comp.inlineLimit = options->inlineLimit;
+    comp.flatAst = options->flatAst;
+    PhaseTimer timer;
+
+    // Map file
+    if (!openSourceBuffer(&comp.source, input)) {
+        fprintf(stderr, "\nError opening rascal file: %s\n", input);
+        return finishCompilation(&comp, options, 1);
     }
 
-    // Open file
-    FILE *myfile = fopen(argv[1], "r");
-    if (!myfile) {
-        fprintf(stderr, "\nError opening rascal file: %s\n", argv[1]);
-        return 1;
+    // Unchanged source: skip every phase
+    char key[CACHE_KEY_SIZE];
+    if (cache) {
+        char codeOptions[32];
+        codeOptionsKey(codeOptions, options->optimize, options->inlineLimit, options->format == MEPA_BINARY);
+        cacheKey(key, codeOptions, comp.source.text, comp.source.length);
+        if (cacheFetch(cache, key, output)) {
+            printf("\nMEPA code loaded from cache: %s", output);
+            return finishCompilation(&comp, options, 0);
+        }
     }
-    yyin = myfile;
 
     // Lexer through Parser with Abstract Syntax Tree Building
-    if (yyparse() != 0 || ast_root == NULL || lexical_errors > 0) {
+    startPhase(&timer);
+    int parsed = parseSource(&comp) == 0 && (comp.flatAst ? comp.flat.complete : comp.astRoot != NULL) &&
+                 comp.lexicalErrors == 0;
+    endPhase(&comp.stats, PHASE_PARSE, &timer);
+    if (!parsed) {
         fprintf(stderr, "\nError while parsing.\n");
-        fclose(myfile);
-        return 1;
+        return finishCompilation(&comp, options, 1);
     }
     printf("\nParsing successful.\n");
+    if (comp.flatAst) {
+        printFlatAstStats(&comp.flat, stdout);
+        countFlatAstNodes(&comp.stats, &comp.flat);
+        comp.stats.astBytes = (long) flatAstBytes(&comp.flat);
+    } else {
+        printArenaStats(&comp.astArena, "AST", stdout);
+        countAstNodes(&comp.stats, comp.astRoot);
+        comp.stats.astBytes = (long) comp.astArena.bytesUsed;
+    }
+    printInternStats(&comp.identifiers, stdout);
 
     // Print Abstract Syntax Tree
+    startPhase(&timer);
     printf("\nPrinting AST:\n");
-    printAstRoot(ast_root, stdout);
+    if (comp.flatAst)
+        printFlatAst(&comp.flat, &comp.identifiers, stdout);
+    else
+        printAstRoot(comp.astRoot, stdout);
+    endPhase(&comp.stats, PHASE_PRINT, &timer);
 
     // Semantic Analysis
-    semanticCheck(ast_root);
+    startPhase(&timer);
+    int checked = semanticCheck(&comp) == 0;
+    endPhase(&comp.stats, PHASE_SEMANTIC, &timer);
+    if (!checked) return finishCompilation(&comp, options, 1);
     printf("\nSuccessful semantic analysis.\n");
 
+    // Optimize Abstract Syntax Tree
+    startPhase(&timer);
+    optimizeProgram(&comp);
+    endPhase(&comp.stats, PHASE_OPTIMIZE, &timer);
+
     // Generate Object MEPA Code
-    generateCode(ast_root, argv[2]);
+    startPhase(&timer);
+    int generated = generateCode(&comp, output, options->format) == 0;
+    endPhase(&comp.stats, PHASE_CODEGEN, &timer);
+    if (!generated) return finishCompilation(&comp, options, 1);
+    if (cache) cacheStore(cache, key, output);
+
+    // Free Abstract Syntax Tree, identifiers and source
+    return finishCompilation(&comp, options, 0);
+}
+
+// Prints a binary object back in the text form, to a file or stdout
+static int disassembleMain(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "\nUsage: rascalc --disassemble <mepa_binary> [<mepa_text>]\n");
+        return 1;
+    }
+
+    MepaObject object;
+    if (!loadMepaObject(&object, argv[1])) {
+        fprintf(stderr, "\nNot a binary MEPA object: %s\n", argv[1]);
+        return 1;
+    }
+
+    MepaBuffer text;
+    initMepaBuffer(&text, MEPA_TEXT);
+    int status = disassembleMepaObject(&object, &text);
+    unloadMepaObject(&object);
+    if (status != 0) {
+        fprintf(stderr, "\nInvalid instruction in binary MEPA object: %s\n", argv[1]);
+        freeMepaBuffer(&text);
+        return 1;
+    }
+
+    int fd = argc > 2 ? open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0666) : STDOUT_FILENO;
+    if (fd < 0 || writeMepaBuffer(&text, fd) != 0) {
+        fprintf(stderr, "\nError writing mepa file: %s\n", argc > 2 ? argv[2] : "stdout");
+        status = 1;
+    }
+    if (argc > 2 && fd >= 0) close(fd);
+    freeMepaBuffer(&text);
+    return status;
+}
+
+int main(int argc, char *argv[]) {
+    // Many files at once
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0)
+        return batchMain(argc - 1, argv + 1);
+
+    // Long running compile server
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0)
+        return serveMain(argc - 1, argv + 1);
+
+    // Binary object back to text
+    if (argc > 1 && strcmp(argv[1], "--disassemble") == 0)
+        return disassembleMain(argc - 1, argv + 1);
+
+    // Options
+    int arg = 1;
+    MainOptions options = {NULL, 0, 0, MEPA_TEXT, 0, INLINE_LIMIT_DEFAULT, 0};
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (parseOptimizeOption(argv[arg]) >= 0) {
+            options.optimize = parseOptimizeOption(argv[arg]);
+        } else if (strcmp(argv[arg], "--cache-dir") == 0 && arg + 1 < argc) {
+            options.cacheDir = argv[++arg];
+        } else if (strcmp(argv[arg], "--inline-limit") == 0 && arg + 1 < argc) {
+            options.inlineLimit = parseInlineLimit(argv[++arg]);
+            if (options.inlineLimit < 0) {
+                fprintf(stderr, "\nInvalid inline limit: %s\n", argv[arg]);
+                return 1;
+            }
+        } else if (strcmp(argv[arg], "--binary") == 0) {
+            options.format = MEPA_BINARY;
+        } else if (strcmp(argv[arg], "--flat-ast") == 0) {
+            options.flatAst = 1;
+        } else if (strcmp(argv[arg], "--stats") == 0) {
+            options.stats = 1;
+        } else if (strcmp(argv[arg], "--stats=json") == 0) {
+            options.stats = 1;
+            options.statsJson = 1;
+        } else {
+            fprintf(stderr, "\nUnknown option: %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    const char *cacheDir = options.cacheDir;
+
+    // The flat layout skips the AST optimizations
+    if (options.flatAst && options.optimize > 0) {
+        fprintf(stderr, "\n--flat-ast compiles at -O0 only\n");
+        return 1;
+    }
 
-    // Free Abstract Syntax Tree and close file
-    freeAstRoot(ast_root);
-    fclose(myfile);
+    // Verify arguments
+    if (argc - arg < 2) {
+        fprintf(stderr, "\nUsage: %s [-O<level>] [--inline-limit <nodes>] [--cache-dir <dir>] [--stats[=json]] [--binary] [--flat-ast] <rascal_file> <mepa_object>\n", argv[0]);
+        fprintf(stderr, "       %s --batch [-j <workers>] [-O<level>] [--inline-limit <nodes>] [--cache-dir <dir>] (<rascal_file>... | --manifest <list_file>)\n", argv[0]);
+        fprintf(stderr, "       %s --serve [-j <workers>] [-O<level>] [--inline-limit <nodes>] <socket_path>\n", argv[0]);
+        fprintf(stderr, "       %s --disassemble <mepa_binary> [<mepa_text>]\n", argv[0]);
+        return 1;
+    }
+
+    CompileCache cache;
+    if (cacheDir && !openCompileCache(&cache, cacheDir)) {
+        fprintf(stderr, "\nError opening cache directory: %s\n", cacheDir);
+        return 1;
+    }
+
+    int status = compileVerbose(argv[arg], argv[arg + 1], cacheDir ? &cache : NULL, &options);
+
+    if (cacheDir) {
+        closeCompileCache(&cache);
+        printCacheStats(&cache, stdout);
+    }
 
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
@@ -0,0 +1,332 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "mepa_emit.h"
+#include "mepa_object.h"
+
+#define MEPA_LINE_MAX 64            // Longest text line: "     CHPR R<int>,<int>\n"
+#define MEPA_BUFFER_INITIAL 4096
+
+// MEPA instruction set, in the order of MepaOpcode
+static const char mepaMnemonics[MEPA_OPCODE_COUNT][5] = {
+    "CRCT", "CRVL", "CRVI", "CREN", "ARMZ", "ARMI", "SOMA", "SUBT", "MULT", "DIVI", "INVR",
+    "CONJ", "DISJ", "NEGA", "CMME", "CMMA", "CMIG", "CMDG", "CMEG", "CMAG", "DSVS", "DSVF",
+    "NADA", "LEIT", "IMPR", "INPP", "AMEM", "DMEM", "PARA", "FIM", "ENPR", "CHPR", "RTPR"
+};
+
+const char* mepaMnemonic(MepaOpcode op) {
+    return mepaMnemonics[op];
+}
+
+// - Buffer -------------------------------
+
+// Starts an empty buffer (no memory is reserved until the first instruction)
+void initMepaBuffer(MepaBuffer* buffer, MepaFormat format) {
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->format = format;
+    buffer->instructionCount = 0;
+    buffer->labels = NULL;
+    buffer->labelCapacity = 0;
+}
+
+// Drops the code, keeping the memory for the next program
+void clearMepaBuffer(MepaBuffer* buffer) {
+    buffer->length = 0;
+    buffer->instructionCount = 0;
+    for (int i = 0; i < buffer->labelCapacity; i++) buffer->labels[i] = -1;
+}
+
+void freeMepaBuffer(MepaBuffer* buffer) {
+    free(buffer->data);
+    free(buffer->labels);
+    initMepaBuffer(buffer, buffer->format);
+}
+
+// Hands the code over as a NUL terminated string (to be freed by the
+// caller), leaving the buffer empty
+char* detachMepaBuffer(MepaBuffer* buffer, size_t* length) {
+    char* text = (char*) realloc(buffer->data, buffer->length + 1);
+    if (!text) {
+        fprintf(stderr, "\nOut of memory.\n");
+        exit(1);
+    }
+    text[buffer->length] = '\0';
+    if (length) *length = buffer->length;
+    free(buffer->labels);
+    initMepaBuffer(buffer, buffer->format);
+    return text;
+}
+
+// Writes the whole buffer to fd: returns 0 on success
+int writeMepaBuffer(const MepaBuffer* buffer, int fd) {
+    size_t done = 0;
+    while (done < buffer->length) {
+        ssize_t n = write(fd, buffer->data + done, buffer->length - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 1;
+        }
+        done += (size_t) n;
+    }
+    return 0;
+}
+
+// Makes room for size more bytes
+static void reserve(MepaBuffer* buffer, size_t size) {
+    if (buffer->capacity - buffer->length < size) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : MEPA_BUFFER_INITIAL;
+        char* data = (char*) realloc(buffer->data, capacity);
+        if (!data) {
+            fprintf(stderr, "\nOut of memory.\n");
+            exit(1);
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+}
+
+// Makes room for one more line and returns where it starts
+static char* reserveLine(MepaBuffer* buffer) {
+    reserve(buffer, MEPA_LINE_MAX);
+    return buffer->data + buffer->length;
+}
+
+static void commitLine(MepaBuffer* buffer, char* end) {
+    buffer->length = end - buffer->data;
+}
+
+// - Binary Encoding ----------------------
+
+// Instructions of a binary buffer, after the space kept for the header
+static MepaObjectInstr* objectCode(const MepaBuffer* buffer) {
+    return (MepaObjectInstr*) (buffer->data + sizeof(MepaObjectHeader));
+}
+
+static void appendObjectInstr(MepaBuffer* buffer, MepaOpcode op, int arg1, int arg2) {
+    if (buffer->length == 0) {
+        reserve(buffer, sizeof(MepaObjectHeader));
+        buffer->length = sizeof(MepaObjectHeader);
+    }
+    reserve(buffer, sizeof(MepaObjectInstr));
+
+    MepaObjectInstr* instr = (MepaObjectInstr*) (buffer->data + buffer->length);
+    memset(instr, 0, sizeof(*instr));
+    instr->opcode = (uint8_t) op;
+    instr->arg1 = arg1;
+    instr->arg2 = arg2;
+    buffer->length += sizeof(MepaObjectInstr);
+    buffer->instructionCount++;
+}
+
+// Records that label is placed at the next instruction
+static void placeLabel(MepaBuffer* buffer, int label) {
+    if (label >= buffer->labelCapacity) {
+        int capacity = buffer->labelCapacity ? buffer->labelCapacity : 64;
+        while (capacity <= label) capacity *= 2;
+        buffer->labels = (int*) realloc(buffer->labels, capacity * sizeof(int));
+        if (!buffer->labels) {
+            fprintf(stderr, "\nOut of memory.\n");
+            exit(1);
+        }
+        for (int i = buffer->labelCapacity; i < capacity; i++) buffer->labels[i] = -1;
+        buffer->labelCapacity = capacity;
+    }
+    buffer->labels[label] = buffer->instructionCount;
+}
+
+static int isJump(int op) {
+    return op == OP_DSVS || op == OP_DSVF || op == OP_CHPR;
+}
+
+// Values an instruction pushes (negative when it pops), for the ones
+// whose effect does not depend on their operands or on the callee
+static const signed char stackEffect[MEPA_OPCODE_COUNT] = {
+    [OP_CRCT] = 1, [OP_CRVL] = 1, [OP_CRVI] = 1, [OP_CREN] = 1, [OP_LEIT] = 1,
+    [OP_ARMZ] = -1, [OP_ARMI] = -1, [OP_DSVF] = -1, [OP_IMPR] = -1,
+    [OP_SOMA] = -1, [OP_SUBT] = -1, [OP_MULT] = -1, [OP_DIVI] = -1, [OP_CONJ] = -1, [OP_DISJ] = -1,
+    [OP_CMME] = -1, [OP_CMMA] = -1, [OP_CMIG] = -1, [OP_CMDG] = -1, [OP_CMEG] = -1, [OP_CMAG] = -1
+};
+
+// Deepest a frame grows, following the code in order: a jump hands its
+// depth to its target label, ENPR starts a frame and a call leaves its
+// arguments popped (RTPR of the callee tells how many)
+static uint32_t maxStackDepth(const MepaObjectInstr* code, int count) {
+    int* depthAt = (int*) malloc((count + 1) * sizeof(int));
+    int* arity = (int*) malloc((count + 1) * sizeof(int));
+
+    // Arguments a call to each instruction drops: the callee body runs
+    // up to its RTPR, subroutines do not nest
+    int pending = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        if (code[i].opcode == OP_RTPR) pending = code[i].arg1;
+        arity[i] = pending;
+        depthAt[i] = -1;
+    }
+
+    int depth = 0, max = 0;
+    for (int i = 0; i < count; i++) {
+        const MepaObjectInstr* in = &code[i];
+        if (depthAt[i] >= 0) depth = depthAt[i];
+
+        switch (in->opcode) {
+            case OP_AMEM: depth += in->arg1; break;
+            case OP_DMEM: depth -= in->arg1; break;
+            case OP_ENPR: depth = 0; break;
+            case OP_CHPR: depth -= arity[in->arg1]; break;
+            default:      depth += stackEffect[in->opcode]; break;
+        }
+        if (depth > max) max = depth;
+
+        if (in->opcode == OP_DSVS || in->opcode == OP_DSVF) depthAt[in->arg1] = depth;
+
+        // What follows is only reached through a label
+        if (in->opcode == OP_DSVS || in->opcode == OP_RTPR) depth = 0;
+    }
+
+    free(depthAt);
+    free(arity);
+    return (uint32_t) max;
+}
+
+// Resolves the labels of a binary buffer into instruction indices and
+// fills its header: returns 0 unless a label was never placed.
+// Text buffers are complete as they are
+int finishMepaBuffer(MepaBuffer* buffer) {
+    if (buffer->format != MEPA_BINARY) return 0;
+    if (buffer->length == 0) {
+        reserve(buffer, sizeof(MepaObjectHeader));
+        buffer->length = sizeof(MepaObjectHeader);
+    }
+
+    MepaObjectInstr* code = objectCode(buffer);
+    for (int i = 0; i < buffer->instructionCount; i++) {
+        if (!isJump(code[i].opcode)) continue;
+        int label = code[i].arg1;
+        if (label < 0 || label >= buffer->labelCapacity || buffer->labels[label] < 0) return 1;
+        code[i].arg1 = buffer->labels[label];
+    }
+
+    MepaObjectHeader* header = (MepaObjectHeader*) buffer->data;
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, MEPA_OBJECT_MAGIC, 4);
+    header->version = MEPA_OBJECT_VERSION;
+    header->instructionCount = (uint32_t) buffer->instructionCount;
+    header->maxStackDepth = maxStackDepth(code, buffer->instructionCount);
+    header->entryPoint = 0;
+    return 0;
+}
+
+// - Text Encoding ------------------------
+
+// Writes value in decimal with at least width digits (as "%0*d")
+static char* putInt(char* p, int value, int width) {
+    unsigned magnitude = value < 0 ? 0u - (unsigned) value : (unsigned) value;
+    if (value < 0) *p++ = '-';
+
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    while (n < width) digits[n++] = '0';
+
+    while (n) *p++ = digits[--n];
+    return p;
+}
+
+// Indentation and mnemonic of an instruction line
+static char* putOp(char* p, MepaOpcode op) {
+    memcpy(p, "     ", 5);
+    p += 5;
+    const char* m = mepaMnemonics[op];
+    while (*m) *p++ = *m++;
+    return p;
+}
+
+// Label reference, as "R%02d"
+static char* putLabel(char* p, int label) {
+    *p++ = 'R';
+    return putInt(p, label, 2);
+}
+
+// - Emission -----------------------------
+
+// Label definition line: "R01: NADA"
+void emitLabel(MepaBuffer* buffer, int label) {
+    if (buffer->format == MEPA_BINARY) {
+        placeLabel(buffer, label);
+        appendObjectInstr(buffer, OP_NADA, label, 0);
+        return;
+    }
+    char* p = putLabel(reserveLine(buffer), label);
+    memcpy(p, ": NADA\n", 7);
+    commitLine(buffer, p + 7);
+}
+
+void emitInstr(MepaBuffer* buffer, MepaOpcode op) {
+    if (buffer->format == MEPA_BINARY) {
+        appendObjectInstr(buffer, op, 0, 0);
+        return;
+    }
+    char* p = putOp(reserveLine(buffer), op);
+    *p++ = '\n';
+    commitLine(buffer, p);
+}
+
+void emitInstrInt(MepaBuffer* buffer, MepaOpcode op, int arg) {
+    if (buffer->format == MEPA_BINARY) {
+        appendObjectInstr(buffer, op, arg, 0);
+        return;
+    }
+    char* p = putOp(reserveLine(buffer), op);
+    *p++ = ' ';
+    p = putInt(p, arg, 1);
+    *p++ = '\n';
+    commitLine(buffer, p);
+}
+
+void emitInstr2Int(MepaBuffer* buffer, MepaOpcode op, int arg1, int arg2) {
+    if (buffer->format == MEPA_BINARY) {
+        appendObjectInstr(buffer, op, arg1, arg2);
+        return;
+    }
+    char* p = putOp(reserveLine(buffer), op);
+    *p++ = ' ';
+    p = putInt(p, arg1, 1);
+    *p++ = ',';
+    p = putInt(p, arg2, 1);
+    *p++ = '\n';
+    commitLine(buffer, p);
+}
+
+void emitInstrLabel(MepaBuffer* buffer, MepaOpcode op, int label) {
+    if (buffer->format == MEPA_BINARY) {
+        appendObjectInstr(buffer, op, label, 0);
+        return;
+    }
+    char* p = putOp(reserveLine(buffer), op);
+    *p++ = ' ';
+    p = putLabel(p, label);
+    *p++ = '\n';
+    commitLine(buffer, p);
+}
+
+// Subroutine call: "CHPR R<label>,<level>"
+void emitCall(MepaBuffer* buffer, int label, int level) {
+    if (buffer->format == MEPA_BINARY) {
+        appendObjectInstr(buffer, OP_CHPR, label, level);
+        return;
+    }
+    char* p = putOp(reserveLine(buffer), OP_CHPR);
+    *p++ = ' ';
+    p = putLabel(p, label);
+    *p++ = ',';
+    p = putInt(p, level, 1);
+    *p++ = '\n';
+    commitLine(buffer, p);
+}
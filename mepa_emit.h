@@ -0,0 +1,53 @@
+#ifndef MEPA_EMIT_H
+#define MEPA_EMIT_H
+
+#include <stddef.h>
+
+// MEPA emitter: instructions are encoded into a growable memory buffer
+// and written out at once, either as text (integers formatted by hand)
+// or as a binary object (see mepa_object.h) whose labels are resolved
+// when the buffer is finished.
+
+// MEPA instruction set
+typedef enum {
+    OP_CRCT, OP_CRVL, OP_CRVI, OP_CREN, OP_ARMZ, OP_ARMI, OP_SOMA, OP_SUBT, OP_MULT, OP_DIVI, OP_INVR,
+    OP_CONJ, OP_DISJ, OP_NEGA, OP_CMME, OP_CMMA, OP_CMIG, OP_CMDG, OP_CMEG, OP_CMAG, OP_DSVS, OP_DSVF,
+    OP_NADA, OP_LEIT, OP_IMPR, OP_INPP, OP_AMEM, OP_DMEM, OP_PARA, OP_FIM, OP_ENPR, OP_CHPR, OP_RTPR,
+    MEPA_OPCODE_COUNT
+} MepaOpcode;
+
+// Output formats
+typedef enum {
+    MEPA_TEXT,
+    MEPA_BINARY
+} MepaFormat;
+
+// Buffer Struct
+typedef struct MepaBuffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+    MepaFormat format;
+    int instructionCount;       // Binary only
+    int* labels;                // Binary only: instruction index of each label, -1 when not placed
+    int labelCapacity;
+} MepaBuffer;
+
+// Buffer functions
+void initMepaBuffer(MepaBuffer* buffer, MepaFormat format);
+void clearMepaBuffer(MepaBuffer* buffer);
+void freeMepaBuffer(MepaBuffer* buffer);
+int finishMepaBuffer(MepaBuffer* buffer);
+char* detachMepaBuffer(MepaBuffer* buffer, size_t* length);
+int writeMepaBuffer(const MepaBuffer* buffer, int fd);
+
+// Emission functions, one MEPA instruction each
+const char* mepaMnemonic(MepaOpcode op);
+void emitLabel(MepaBuffer* buffer, int label);
+void emitInstr(MepaBuffer* buffer, MepaOpcode op);
+void emitInstrInt(MepaBuffer* buffer, MepaOpcode op, int arg);
+void emitInstr2Int(MepaBuffer* buffer, MepaOpcode op, int arg1, int arg2);
+void emitInstrLabel(MepaBuffer* buffer, MepaOpcode op, int label);
+void emitCall(MepaBuffer* buffer, int label, int level);
+
+#endif
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "mepa_ir.h"
+
+// Starts an empty list (no memory is reserved until the first instruction)
+void initMepaCode(MepaCode* code) {
+    code->instrs = NULL;
+    code->count = 0;
+    code->capacity = 0;
+    code->labelCount = 0;
+}
+
+// Drops the instructions, keeping the memory for the next program
+void clearMepaCode(MepaCode* code) {
+    code->count = 0;
+    code->labelCount = 0;
+}
+
+void freeMepaCode(MepaCode* code) {
+    free(code->instrs);
+    initMepaCode(code);
+}
+
+void appendMepaInstr(MepaCode* code, MepaOpcode op, int arg1, int arg2) {
+    if (code->count == code->capacity) {
+        code->capacity = code->capacity ? code->capacity * 2 : 1024;
+        code->instrs = (MepaInstr*) realloc(code->instrs, code->capacity * sizeof(MepaInstr));
+        if (!code->instrs) {
+            fprintf(stderr, "\nOut of memory.\n");
+            exit(1);
+        }
+    }
+    MepaInstr* instr = &code->instrs[code->count++];
+    instr->op = op;
+    instr->arg1 = arg1;
+    instr->arg2 = arg2;
+    if ((isLabelDefinition(instr) || isLabelReference(instr)) && arg1 >= code->labelCount)
+        code->labelCount = arg1 + 1;
+}
+
+int isLabelDefinition(const MepaInstr* instr) {
+    return instr->op == OP_NADA;
+}
+
+int isLabelReference(const MepaInstr* instr) {
+    return instr->op == OP_DSVS || instr->op == OP_DSVF || instr->op == OP_CHPR;
+}
+
+// Marks an instruction for removal, so passes can keep indices stable
+// while they scan
+void removeMepaInstr(MepaCode* code, int index) {
+    code->instrs[index].op = OP_REMOVED;
+}
+
+// Drops the instructions marked for removal: returns how many
+int compactMepaCode(MepaCode* code) {
+    int kept = 0;
+    for (int i = 0; i < code->count; i++)
+        if (code->instrs[i].op != OP_REMOVED) code->instrs[kept++] = code->instrs[i];
+
+    int removed = code->count - kept;
+    code->count = kept;
+    return removed;
+}
+
+// Serializes the list into a buffer, in the buffer's format: returns 0
+// on success
+int writeMepaCode(const MepaCode* code, MepaBuffer* out) {
+    for (int i = 0; i < code->count; i++) {
+        const MepaInstr* in = &code->instrs[i];
+        switch (in->op) {
+            case OP_NADA:
+                emitLabel(out, in->arg1);
+                break;
+            case OP_DSVS:
+            case OP_DSVF:
+                emitInstrLabel(out, in->op, in->arg1);
+                break;
+            case OP_CHPR:
+                emitCall(out, in->arg1, in->arg2);
+                break;
+            case OP_CRCT:
+            case OP_AMEM:
+            case OP_DMEM:
+            case OP_ENPR:
+            case OP_RTPR:
+                emitInstrInt(out, in->op, in->arg1);
+                break;
+            case OP_CRVL:
+            case OP_CRVI:
+            case OP_CREN:
+            case OP_ARMZ:
+            case OP_ARMI:
+                emitInstr2Int(out, in->op, in->arg1, in->arg2);
+                break;
+            default:
+                emitInstr(out, in->op);
+                break;
+        }
+    }
+    return finishMepaBuffer(out);
+}
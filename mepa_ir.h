@@ -0,0 +1,39 @@
+#ifndef MEPA_IR_H
+#define MEPA_IR_H
+
+#include "mepa_emit.h"
+
+// MEPA instruction list: the code generator appends to it, optimization
+// passes rewrite it in place and writeMepaCode serializes it. Labels are
+// numbers: a NADA instruction defines the label in arg1, and DSVS, DSVF
+// and CHPR refer to one in arg1.
+
+#define OP_REMOVED MEPA_OPCODE_COUNT    // Instruction dropped by the next compactMepaCode
+
+// Instruction Struct
+typedef struct MepaInstr {
+    MepaOpcode op;
+    int arg1;                   // Operand, or label defined or referred to
+    int arg2;                   // Second operand (CHPR: level)
+} MepaInstr;
+
+// Code Struct
+typedef struct MepaCode {
+    MepaInstr* instrs;
+    int count;
+    int capacity;
+    int labelCount;             // Labels are numbered from 0 to labelCount - 1
+} MepaCode;
+
+// Code functions
+void initMepaCode(MepaCode* code);
+void clearMepaCode(MepaCode* code);
+void freeMepaCode(MepaCode* code);
+void appendMepaInstr(MepaCode* code, MepaOpcode op, int arg1, int arg2);
+int isLabelDefinition(const MepaInstr* instr);
+int isLabelReference(const MepaInstr* instr);
+void removeMepaInstr(MepaCode* code, int index);
+int compactMepaCode(MepaCode* code);
+int writeMepaCode(const MepaCode* code, MepaBuffer* out);
+
+#endif
@@ -0,0 +1,104 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mepa_object.h"
+
+// Operands of each instruction in the text form
+typedef enum {
+    OPERANDS_NONE,
+    OPERANDS_INT,
+    OPERANDS_INT_PAIR,
+    OPERANDS_LABEL,
+    OPERANDS_CALL
+} OperandKind;
+
+static const unsigned char operandKinds[MEPA_OPCODE_COUNT] = {
+    [OP_CRCT] = OPERANDS_INT, [OP_AMEM] = OPERANDS_INT, [OP_DMEM] = OPERANDS_INT,
+    [OP_ENPR] = OPERANDS_INT, [OP_RTPR] = OPERANDS_INT,
+    [OP_CRVL] = OPERANDS_INT_PAIR, [OP_CRVI] = OPERANDS_INT_PAIR, [OP_CREN] = OPERANDS_INT_PAIR,
+    [OP_ARMZ] = OPERANDS_INT_PAIR, [OP_ARMI] = OPERANDS_INT_PAIR,
+    [OP_DSVS] = OPERANDS_LABEL, [OP_DSVF] = OPERANDS_LABEL,
+    [OP_CHPR] = OPERANDS_CALL
+};
+
+// Maps a binary object: returns 1 when it was mapped and its header
+// matches its size. Instructions are used in place, nothing is parsed
+int loadMepaObject(MepaObject* object, const char* path) {
+    memset(object, 0, sizeof(*object));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(MepaObjectHeader)) {
+        close(fd);
+        return 0;
+    }
+
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+
+    object->header = (const MepaObjectHeader*) map;
+    object->code = (const MepaObjectInstr*) ((const char*) map + sizeof(MepaObjectHeader));
+    object->mapLength = st.st_size;
+
+    const MepaObjectHeader* h = object->header;
+    if (memcmp(h->magic, MEPA_OBJECT_MAGIC, 4) != 0 || h->version != MEPA_OBJECT_VERSION ||
+        object->mapLength != sizeof(MepaObjectHeader) + (size_t) h->instructionCount * sizeof(MepaObjectInstr)) {
+        unloadMepaObject(object);
+        return 0;
+    }
+    return 1;
+}
+
+void unloadMepaObject(MepaObject* object) {
+    if (object->header) munmap((void*) object->header, object->mapLength);
+    memset(object, 0, sizeof(*object));
+}
+
+// Label a jump or call lands on: the number kept by the NADA at its target
+static int targetLabel(const MepaObject* object, int32_t target) {
+    if (target < 0 || (uint32_t) target >= object->header->instructionCount) return -1;
+    if (object->code[target].opcode != OP_NADA) return -1;
+    return object->code[target].arg1;
+}
+
+// Appends the text form of a binary object to a text buffer: returns 0
+// unless an instruction is not valid MEPA
+int disassembleMepaObject(const MepaObject* object, MepaBuffer* text) {
+    for (uint32_t i = 0; i < object->header->instructionCount; i++) {
+        const MepaObjectInstr* in = &object->code[i];
+        if (in->opcode >= MEPA_OPCODE_COUNT) return 1;
+        MepaOpcode op = (MepaOpcode) in->opcode;
+
+        if (op == OP_NADA) {
+            emitLabel(text, in->arg1);
+            continue;
+        }
+
+        int label;
+        switch (operandKinds[op]) {
+            case OPERANDS_NONE:
+                emitInstr(text, op);
+                break;
+            case OPERANDS_INT:
+                emitInstrInt(text, op, in->arg1);
+                break;
+            case OPERANDS_INT_PAIR:
+                emitInstr2Int(text, op, in->arg1, in->arg2);
+                break;
+            case OPERANDS_LABEL:
+                if ((label = targetLabel(object, in->arg1)) < 0) return 1;
+                emitInstrLabel(text, op, label);
+                break;
+            case OPERANDS_CALL:
+                if ((label = targetLabel(object, in->arg1)) < 0) return 1;
+                emitCall(text, label, in->arg2);
+                break;
+        }
+    }
+    return 0;
+}
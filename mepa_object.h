@@ -0,0 +1,46 @@
+#ifndef MEPA_OBJECT_H
+#define MEPA_OBJECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mepa_emit.h"
+
+// Binary MEPA object: a header followed by fixed width instructions, in
+// host byte order. Jump and call targets are instruction indices, so a
+// loader maps the file and runs it without parsing. Each NADA keeps the
+// number of its label, which the disassembler uses to restore the text.
+
+#define MEPA_OBJECT_MAGIC "MEPB"
+#define MEPA_OBJECT_VERSION 1
+
+// Header Struct
+typedef struct MepaObjectHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t instructionCount;
+    uint32_t maxStackDepth;     // Cells one frame takes at most: locals and temporaries, not the calls it makes
+    uint32_t entryPoint;        // Index of the first instruction to run
+    uint32_t reserved;
+} MepaObjectHeader;
+
+// Instruction Struct
+typedef struct MepaObjectInstr {
+    uint8_t opcode;             // MepaOpcode
+    uint8_t reserved[3];
+    int32_t arg1;               // DSVS, DSVF, CHPR: target index; NADA: label number
+    int32_t arg2;
+} MepaObjectInstr;
+
+// Mapped object
+typedef struct MepaObject {
+    const MepaObjectHeader* header;
+    const MepaObjectInstr* code;
+    size_t mapLength;
+} MepaObject;
+
+// Object functions
+int loadMepaObject(MepaObject* object, const char* path);
+void unloadMepaObject(MepaObject* object);
+int disassembleMepaObject(const MepaObject* object, MepaBuffer* text);
+
+#endif
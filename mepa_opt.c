@@ -0,0 +1,238 @@
+#include <stdlib.h>
+#include "mepa_opt.h"
+
+#define OPT_MAX_ROUNDS 8            // -O2 gives up iterating after this many rounds
+
+// - Passes -------------------------------
+
+// Drops the NADA of labels no jump or call refers to
+static int removeUnusedLabels(MepaCode* code, CompileStats* stats) {
+    if (code->labelCount == 0) return 0;
+    char* used = (char*) calloc(code->labelCount, 1);
+
+    for (int i = 0; i < code->count; i++)
+        if (isLabelReference(&code->instrs[i])) used[code->instrs[i].arg1] = 1;
+
+    for (int i = 0; i < code->count; i++)
+        if (isLabelDefinition(&code->instrs[i]) && !used[code->instrs[i].arg1]) removeMepaInstr(code, i);
+
+    free(used);
+    return compactMepaCode(code);
+}
+
+// - Peephole -----------------------------
+
+// Index of the NADA defining each label, -1 when none (to be freed)
+static int* mapLabels(const MepaCode* code) {
+    int* at = (int*) malloc((code->labelCount + 1) * sizeof(int));
+    for (int l = 0; l < code->labelCount; l++) at[l] = -1;
+    for (int i = 0; i < code->count; i++)
+        if (isLabelDefinition(&code->instrs[i])) at[code->instrs[i].arg1] = i;
+    return at;
+}
+
+// Whether the instructions from index up to label define nothing but labels
+static int onlyLabelsUntil(const MepaCode* code, int index, int label) {
+    for (int i = index; i < code->count && isLabelDefinition(&code->instrs[i]); i++)
+        if (code->instrs[i].arg1 == label) return 1;
+    return 0;
+}
+
+static int sameOperands(const MepaInstr* a, const MepaInstr* b) {
+    return a->arg1 == b->arg1 && a->arg2 == b->arg2;
+}
+
+// Labels defined one after the other become the first of them
+static int mergeLabelChains(MepaCode* code) {
+    if (code->labelCount == 0) return 0;
+    int* alias = (int*) malloc(code->labelCount * sizeof(int));
+    for (int l = 0; l < code->labelCount; l++) alias[l] = l;
+
+    int first = -1;                 // First label of the current chain, -1 outside one
+    for (int i = 0; i < code->count; i++) {
+        MepaInstr* in = &code->instrs[i];
+        if (!isLabelDefinition(in)) {
+            first = -1;
+        } else if (first < 0) {
+            first = in->arg1;
+        } else {
+            alias[in->arg1] = first;
+            removeMepaInstr(code, i);
+        }
+    }
+    for (int i = 0; i < code->count; i++)
+        if (isLabelReference(&code->instrs[i])) code->instrs[i].arg1 = alias[code->instrs[i].arg1];
+
+    free(alias);
+    return compactMepaCode(code);
+}
+
+// Jumps to an unconditional jump go straight to its target
+static int threadJumps(MepaCode* code) {
+    int* at = mapLabels(code);
+    int retargeted = 0;
+
+    for (int i = 0; i < code->count; i++) {
+        MepaInstr* in = &code->instrs[i];
+        if (in->op != OP_DSVS && in->op != OP_DSVF) continue;
+
+        int label = in->arg1;
+        for (int hops = 0; hops < 16; hops++) {
+            int t = at[label];
+            while (t >= 0 && t < code->count && isLabelDefinition(&code->instrs[t])) t++;
+            if (t < 0 || t >= code->count || code->instrs[t].op != OP_DSVS || code->instrs[t].arg1 == label) break;
+            label = code->instrs[t].arg1;
+        }
+        if (label != in->arg1) {
+            in->arg1 = label;
+            retargeted++;
+        }
+    }
+
+    free(at);
+    return retargeted;
+}
+
+// DSVS to a label that follows it
+static int removeJumpsToNext(MepaCode* code) {
+    for (int i = 0; i < code->count; i++)
+        if (code->instrs[i].op == OP_DSVS && onlyLabelsUntil(code, i + 1, code->instrs[i].arg1))
+            removeMepaInstr(code, i);
+    return compactMepaCode(code);
+}
+
+// Instructions between DSVS or RTPR and the next label never run
+static int removeUnreachable(MepaCode* code) {
+    for (int i = 0; i < code->count; i++) {
+        MepaOpcode op = code->instrs[i].op;
+        if (op != OP_DSVS && op != OP_RTPR) continue;
+        while (i + 1 < code->count && !isLabelDefinition(&code->instrs[i + 1]) && code->instrs[i + 1].op != OP_FIM)
+            removeMepaInstr(code, ++i);
+    }
+    return compactMepaCode(code);
+}
+
+// CRCT 0/1 then NEGA is the other constant; NEGA NEGA and INVR INVR cancel
+static int foldNegations(MepaCode* code) {
+    for (int i = 0; i + 1 < code->count; i++) {
+        MepaInstr* a = &code->instrs[i];
+        MepaInstr* b = a + 1;
+        if (a->op == OP_CRCT && (a->arg1 == 0 || a->arg1 == 1) && b->op == OP_NEGA) {
+            a->arg1 = 1 - a->arg1;
+            removeMepaInstr(code, ++i);
+        } else if ((a->op == OP_NEGA || a->op == OP_INVR) && b->op == a->op) {
+            removeMepaInstr(code, i);
+            removeMepaInstr(code, ++i);
+        }
+    }
+    return compactMepaCode(code);
+}
+
+// CRVL x then ARMZ x stores back the value just loaded. (ARMZ x then
+// CRVL x cannot be fused: MEPA has no instruction to duplicate the top)
+static int removeSelfAssignments(MepaCode* code) {
+    for (int i = 0; i + 1 < code->count; i++) {
+        MepaInstr* a = &code->instrs[i];
+        if (a->op == OP_CRVL && a[1].op == OP_ARMZ && sameOperands(a, a + 1)) {
+            removeMepaInstr(code, i);
+            removeMepaInstr(code, ++i);
+        }
+    }
+    return compactMepaCode(code);
+}
+
+// Adjacent AMEM and DMEM add up, or cancel out
+static int mergeMemory(MepaCode* code) {
+    for (int i = 0; i < code->count; i++) {
+        MepaInstr* a = &code->instrs[i];
+        if (a->op != OP_AMEM && a->op != OP_DMEM) continue;
+
+        // Cells allocated so far (negative when released)
+        int cells = a->op == OP_AMEM ? a->arg1 : -a->arg1;
+        int j = i + 1;
+        for (; j < code->count && (code->instrs[j].op == OP_AMEM || code->instrs[j].op == OP_DMEM); j++) {
+            cells += code->instrs[j].op == OP_AMEM ? code->instrs[j].arg1 : -code->instrs[j].arg1;
+            removeMepaInstr(code, j);
+        }
+
+        if (cells == 0) {
+            removeMepaInstr(code, i);
+        } else {
+            a->op = cells > 0 ? OP_AMEM : OP_DMEM;
+            a->arg1 = cells > 0 ? cells : -cells;
+        }
+        i = j - 1;
+    }
+    return compactMepaCode(code);
+}
+
+// CRCT then DSVF: the jump is always or never taken
+static int foldConstantBranches(MepaCode* code) {
+    for (int i = 0; i + 1 < code->count; i++) {
+        MepaInstr* a = &code->instrs[i];
+        if (a->op != OP_CRCT || a[1].op != OP_DSVF) continue;
+        if (a->arg1 == 0) {
+            a[1].op = OP_DSVS;
+            removeMepaInstr(code, i);
+        } else {
+            removeMepaInstr(code, i);
+            removeMepaInstr(code, i + 1);
+        }
+        i++;
+    }
+    return compactMepaCode(code);
+}
+
+// Peephole rules in the order they run. Each counts the instructions
+// it removed, jump threading the jumps it retargeted
+static const struct {
+    const char* name;
+    int (*apply)(MepaCode* code);
+} peepholeRules[] = {
+    {"peephole.constant-branch", foldConstantBranches},
+    {"peephole.negation", foldNegations},
+    {"peephole.self-assign", removeSelfAssignments},
+    {"peephole.memory", mergeMemory},
+    {"peephole.label-chain", mergeLabelChains},
+    {"peephole.jump-thread", threadJumps},
+    {"peephole.unreachable", removeUnreachable},
+    {"peephole.jump-to-next", removeJumpsToNext},
+};
+
+// Rewrites short instruction windows into fewer instructions
+static int peephole(MepaCode* code, CompileStats* stats) {
+    int changes = 0;
+    for (size_t r = 0; r < sizeof(peepholeRules) / sizeof(peepholeRules[0]); r++) {
+        int n = peepholeRules[r].apply(code);
+        countOptimization(stats, peepholeRules[r].name, n);
+        changes += n;
+    }
+    return changes;
+}
+
+// Passes in the order they run
+static const MepaPass passes[] = {
+    {"peephole", 1, peephole},
+    {"unused-labels", 1, removeUnusedLabels},
+};
+
+#define PASS_COUNT ((int) (sizeof(passes) / sizeof(passes[0])))
+
+// - Pass Manager -------------------------
+
+// Runs the passes of an optimization level over the code, counting the
+// changes of each pass in stats
+void runMepaPasses(MepaCode* code, int level, CompileStats* stats) {
+    int rounds = level >= 2 ? OPT_MAX_ROUNDS : 1;
+
+    for (int round = 0; round < rounds; round++) {
+        int changes = 0;
+        for (int p = 0; p < PASS_COUNT; p++) {
+            if (passes[p].level > level) continue;
+            int n = passes[p].run(code, stats);
+            countOptimization(stats, passes[p].name, n);
+            changes += n;
+        }
+        if (changes == 0) break;
+    }
+}
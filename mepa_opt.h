@@ -0,0 +1,27 @@
+#ifndef MEPA_OPT_H
+#define MEPA_OPT_H
+
+#include "mepa_ir.h"
+#include "compile_stats.h"
+
+// Pass manager over the MEPA instruction list. Each pass declares the
+// lowest -O level that runs it: -O0 runs none, -O1 runs its passes once
+// and -O2 repeats them until none changes the code.
+
+#define OPT_LEVEL_MAX 2
+
+// A pass rewrites the code in place and returns how many changes it
+// made (0 when the code is left as it was)
+typedef int (*MepaPassFunction)(MepaCode* code, CompileStats* stats);
+
+// Pass Struct
+typedef struct MepaPass {
+    const char* name;
+    int level;                  // Lowest -O level running the pass
+    MepaPassFunction run;
+} MepaPass;
+
+// Pass manager functions
+void runMepaPasses(MepaCode* code, int level, CompileStats* stats);
+
+#endif
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rascal.h"
+#include "compilation.h"
+#include "semantics.h"
+#include "rascal_opt.h"
+#include "rascal_inline.h"
+#include "rascal_mepa.h"
+
+// Warm compiler: a compilation reset between programs
+struct RascalCompiler {
+    Compilation comp;
+};
+
+// Creates a compiler whose memory pools are reused by each compilation
+RascalCompiler* rascal_compiler_new(void) {
+    RascalCompiler* compiler = (RascalCompiler*) malloc(sizeof(RascalCompiler));
+    if (compiler) initCompilation(&compiler->comp);
+    return compiler;
+}
+
+// Compiles source text into MEPA text: returns 0 on success.
+// The result must be released with rascal_free_result
+int rascal_compiler_compile(RascalCompiler* compiler, const char* src, size_t len,
+                            const RascalOptions* options, RascalResult* result) {
+    memset(result, 0, sizeof(*result));
+
+    Compilation* comp = &compiler->comp;
+    resetCompilation(comp);
+    comp->log = options ? options->log : NULL;
+    comp->optimize = options ? options->optimize : 0;
+    comp->inlineLimit = options ? options->inlineLimit : INLINE_LIMIT_DEFAULT;
+
+    int status = 1;
+    if (!copySourceBuffer(&comp->source, src, len)) {
+        reportError(comp, RASCAL_INPUT_ERROR, 0, "Out of memory copying the source");
+    } else if (parseSource(comp) == 0 && comp->astRoot && comp->lexicalErrors == 0 &&
+               semanticCheck(comp) == 0) {
+        optimizeProgram(comp);
+
+        MepaBuffer code;
+        initMepaBuffer(&code, MEPA_TEXT);
+        generateCodeBuffer(comp, &code);
+        result->mepa = detachMepaBuffer(&code, &result->mepaLength);
+        status = 0;
+    }
+
+    // Diagnostics outlive the compilation
+    result->status = status;
+    result->diagnostics = comp->diagnostics;
+    result->diagnosticCount = comp->diagnosticCount;
+    comp->diagnostics = NULL;
+    comp->diagnosticCount = 0;
+    comp->diagnosticCapacity = 0;
+
+    return status;
+}
+
+// Releases a compiler and its memory pools
+void rascal_compiler_free(RascalCompiler* compiler) {
+    if (!compiler) return;
+    freeCompilation(&compiler->comp);
+    free(compiler);
+}
+
+// One shot compilation with a temporary compiler
+int rascal_compile(const char* src, size_t len, const RascalOptions* options, RascalResult* result) {
+    RascalCompiler* compiler = rascal_compiler_new();
+    if (!compiler) {
+        memset(result, 0, sizeof(*result));
+        result->status = 1;
+        return 1;
+    }
+
+    int status = rascal_compiler_compile(compiler, src, len, options, result);
+    rascal_compiler_free(compiler);
+    return status;
+}
+
+// Releases the MEPA text and the diagnostics of a result
+void rascal_free_result(RascalResult* result) {
+    for (int i = 0; i < result->diagnosticCount; i++)
+        free(result->diagnostics[i].message);
+    free(result->diagnostics);
+    free(result->mepa);
+    memset(result, 0, sizeof(*result));
+}
@@ -0,0 +1,61 @@
+#ifndef RASCAL_H
+#define RASCAL_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// librascal: compiles Rascal source held in memory into MEPA code
+// held in memory, reporting errors as structured diagnostics.
+
+// Compiler version: part of every compile cache key, so it must change
+// whenever the generated code may change
+#define RASCAL_VERSION "1.1"
+
+// Phase a diagnostic comes from
+typedef enum {
+    RASCAL_INPUT_ERROR,
+    RASCAL_LEXICAL_ERROR,
+    RASCAL_SYNTAX_ERROR,
+    RASCAL_SEMANTIC_ERROR,
+    RASCAL_OUTPUT_ERROR,
+    RASCAL_WARNING              // Does not stop the compilation
+} RascalPhase;
+
+// Diagnostic Struct
+typedef struct RascalDiagnostic {
+    RascalPhase phase;
+    int line;                   // Source line, 0 when unknown
+    char* message;
+} RascalDiagnostic;
+
+// Compilation options
+typedef struct RascalOptions {
+    FILE* log;                  // Also print messages as rascalc does, NULL for none
+    int optimize;               // Optimization level: 0 (none) to 2, as rascalc -O
+    int inlineLimit;            // Largest subroutine body inlined at -O2, 0 for none,
+                                // as rascalc --inline-limit (its default is 16)
+} RascalOptions;
+
+// Compilation result
+typedef struct RascalResult {
+    int status;                 // 0 when MEPA code was generated
+    char* mepa;                 // MEPA program text, NUL terminated
+    size_t mepaLength;
+    RascalDiagnostic* diagnostics;
+    int diagnosticCount;
+} RascalResult;
+
+// Warm compiler state (memory pools) reused between compilations.
+// A compiler must only be used by one thread at a time
+typedef struct RascalCompiler RascalCompiler;
+
+// Library functions
+int rascal_compile(const char* src, size_t len, const RascalOptions* options, RascalResult* result);
+void rascal_free_result(RascalResult* result);
+
+RascalCompiler* rascal_compiler_new(void);
+int rascal_compiler_compile(RascalCompiler* compiler, const char* src, size_t len,
+                            const RascalOptions* options, RascalResult* result);
+void rascal_compiler_free(RascalCompiler* compiler);
+
+#endif
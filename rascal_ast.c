@@ -1,20 +1,74 @@
 #include "rascal_ast.h"
+#include "intern_table.h"
+#include <assert.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 
+// Size of a Command or Expression node holding only the given union member
+#define COMMAND_SIZE(member) (offsetof(Command, cmdU) + sizeof(((Command*)0)->cmdU.member))
+#define EXPRESSION_SIZE(member) (offsetof(Expression, exprU) + sizeof(((Expression*)0)->exprU.member))
+
+// - Token Conversion ---------------------
+
+// Interns an identifier slice of the source buffer
+char* sliceToIdentifier(InternTable* identifiers, Slice slice) {
+    return internIdentifier(identifiers, slice.text, slice.length);
+}
+
+// - Expression Types ---------------------
+
+// Operators decide the type of operations; variables carry the type
+// found by the semantic analysis and calls the type of their target
+varType expressionType(const Expression* e) {
+    switch (e->type) {
+        case Binary:
+            switch (e->operator) {
+                case Plus: case Minus: case Multiplication: case Division:
+                    return Int;
+                default:
+                    return Bool;
+            }
+        case Unary:     return e->operator == Not ? Bool : Int;
+        case Var:       return e->exprU.varExpr.valueType;
+        case ConstInt:  return Int;
+        case ConstBool: return Bool;
+        case FuncCall:  return e->exprU.funCallExpr.target->subrotU.funcInfo.returnType;
+    }
+    return Int;
+}
+
+// Size of an Expression node of the given kind
+static size_t expressionSize(exprType type) {
+    switch (type) {
+        case Binary:    return EXPRESSION_SIZE(binExpr);
+        case Unary:     return EXPRESSION_SIZE(unyExpr);
+        case Var:       return EXPRESSION_SIZE(varExpr);
+        case ConstInt:  return EXPRESSION_SIZE(intExpr);
+        case ConstBool: return EXPRESSION_SIZE(boolExpr);
+        case FuncCall:  return EXPRESSION_SIZE(funCallExpr);
+    }
+    return sizeof(Expression);
+}
+
+void changeExpressionKind(Expression* e, exprType type) {
+    assert(expressionSize(type) <= expressionSize(e->type));
+    e->type = type;
+}
+
 // - Constructors -------------------------
 
 // Program Node Constructor
-Program* newProgram(char* identifier, Block* block) {
-    Program* p = (Program*)malloc(sizeof(Program));
+Program* newProgram(Arena* arena, char* identifier, Block* block) {
+    Program* p = (Program*)arenaAlloc(arena, sizeof(Program));
     p->identifier = identifier;
     p->block = block;
     return p;
 }
 
 // Block Node Constructor
-Block* newBlock(VarDeclaration* varDeclarations, SubRotDeclaration* subRotDeclarations, Command* commandList) {
-    Block* b = (Block*)malloc(sizeof(Block));
+Block* newBlock(Arena* arena, VarDeclaration* varDeclarations, SubRotDeclaration* subRotDeclarations, Command* commandList) {
+    Block* b = (Block*)arenaAlloc(arena, sizeof(Block));
     b->varDeclarations = varDeclarations;
     b->subRotDeclarations = subRotDeclarations;
     b->commandList = commandList;
@@ -22,8 +76,8 @@ Block* newBlock(VarDeclaration* varDeclarations, SubRotDeclaration* subRotDeclar
 }
 
 // Variable Declaration Node Constructor
-VarDeclaration* newVarDeclaration(varType type, char* identifier) {
-    VarDeclaration* vd = (VarDeclaration*)malloc(sizeof(VarDeclaration));
+VarDeclaration* newVarDeclaration(Arena* arena, varType type, char* identifier) {
+    VarDeclaration* vd = (VarDeclaration*)arenaAlloc(arena, sizeof(VarDeclaration));
     vd->type = type;
     vd->identifier = identifier;
     vd->next = NULL;
@@ -31,67 +85,78 @@ VarDeclaration* newVarDeclaration(varType type, char* identifier) {
 }
 
 // Identifier Node Constructor
-IdentifierList* newIdentifierList(char* identifier) {
-    IdentifierList* il = (IdentifierList*)malloc(sizeof(IdentifierList));
+IdentifierList* newIdentifierList(Arena* arena, char* identifier) {
+    IdentifierList* il = (IdentifierList*)arenaAlloc(arena, sizeof(IdentifierList));
     il->identifier = identifier;
+    il->binding.level = 0;
+    il->binding.offset = 0;
     il->next = NULL;
     return il;
 }
 
 // Procedure Declaration Node Constructor
-SubRotDeclaration* newProcDeclaration(char* identifier, VarDeclaration* formParams, SubRotBlock* subRotBlock) {
-    SubRotDeclaration* pd = (SubRotDeclaration*)malloc(sizeof(SubRotDeclaration));
+SubRotDeclaration* newProcDeclaration(Arena* arena, char* identifier, VarDeclaration* formParams, SubRotBlock* subRotBlock) {
+    SubRotDeclaration* pd = (SubRotDeclaration*)arenaAlloc(arena, sizeof(SubRotDeclaration));
     pd->type = Proc;
     pd->subrotU.procInfo.identifier = identifier;
     pd->subrotU.procInfo.formParams = formParams;
     pd->subrotU.procInfo.subRotBlock = subRotBlock;
+    pd->label = -1;
+    pd->calls = 0;
+    pd->pure = 0;
     pd->next = NULL;
     return pd;
 }
 
 // Function Declaration Node Constructor
-SubRotDeclaration* newFuncDeclaration(char* identifier, VarDeclaration* formParams, varType returnType, SubRotBlock* subRotBlock) {
-    SubRotDeclaration* fd = (SubRotDeclaration*)malloc(sizeof(SubRotDeclaration));
+SubRotDeclaration* newFuncDeclaration(Arena* arena, char* identifier, VarDeclaration* formParams, varType returnType, SubRotBlock* subRotBlock) {
+    SubRotDeclaration* fd = (SubRotDeclaration*)arenaAlloc(arena, sizeof(SubRotDeclaration));
     fd->type = Func;
     fd->subrotU.funcInfo.identifier = identifier;
     fd->subrotU.funcInfo.formParams = formParams;
     fd->subrotU.funcInfo.returnType = returnType;
     fd->subrotU.funcInfo.subRotBlock = subRotBlock;
+    fd->label = -1;
+    fd->calls = 0;
+    fd->pure = 0;
     fd->next = NULL;
     return fd;
 }
 
 // Subroutine Block Node Constructor
-SubRotBlock* newSubRotBlock(VarDeclaration* varDeclarations, Command* commands) {
-    SubRotBlock* srb = (SubRotBlock*)malloc(sizeof(SubRotBlock));
+SubRotBlock* newSubRotBlock(Arena* arena, VarDeclaration* varDeclarations, Command* commands) {
+    SubRotBlock* srb = (SubRotBlock*)arenaAlloc(arena, sizeof(SubRotBlock));
     srb->varDeclarations = varDeclarations;
     srb->commands = commands;
     return srb;
 }
 
 // Assign Command Node Constructor
-Command* newAssignCommand(char* identifier, Expression* expression) {
-    Command* ac = (Command*)malloc(sizeof(Command));
+Command* newAssignCommand(Arena* arena, char* identifier, Expression* expression) {
+    Command* ac = (Command*)arenaAlloc(arena, COMMAND_SIZE(assignInfo));
     ac->type = Assign;
     ac->cmdU.assignInfo.identifier = identifier;
     ac->cmdU.assignInfo.expression = expression;
+    ac->cmdU.assignInfo.binding.level = 0;
+    ac->cmdU.assignInfo.binding.offset = 0;
     ac->next = NULL;
     return ac;
 }
 
 // Procedure Call Command Node Constructor
-Command* newProcCallCommand(char* identifier, Expression* expressionList) {
-    Command* pc = (Command*)malloc(sizeof(Command));
+Command* newProcCallCommand(Arena* arena, char* identifier, Expression* expressionList) {
+    Command* pc = (Command*)arenaAlloc(arena, COMMAND_SIZE(procCallInfo));
     pc->type = ProcCall;
     pc->cmdU.procCallInfo.identifier = identifier;
     pc->cmdU.procCallInfo.expressionList = expressionList;
+    pc->cmdU.procCallInfo.target = NULL;
     pc->next = NULL;
     return pc;
 }
 
 // Conditional Command Node Constructor
-Command* newCondCommand(Expression* condExpression, Command* cmdIf, Command* cmdElse) {
-    Command* cc = (Command*)malloc(sizeof(Command));
+Command* newCondCommand(Arena* arena, Expression* condExpression, Command* cmdIf, Command* cmdElse) {
+    Command* cc = (Command*)arenaAlloc(arena, COMMAND_SIZE(condInfo));
     cc->type = Conditional;
     cc->cmdU.condInfo.condExpression = condExpression;
     cc->cmdU.condInfo.cmdIf = cmdIf;
@@ -101,8 +166,8 @@ Command* newCondCommand(Expression* condExpression, Command* cmdIf, Command* cmd
 }
 
 // Looping Command Node Constructor
-Command* newLoopCommand(Expression* loopExpression, Command* cmdLoop) {
-    Command* lc = (Command*)malloc(sizeof(Command));
+Command* newLoopCommand(Arena* arena, Expression* loopExpression, Command* cmdLoop) {
+    Command* lc = (Command*)arenaAlloc(arena, COMMAND_SIZE(loopInfo));
     lc->type = Loop;
     lc->cmdU.loopInfo.loopExpression = loopExpression;
     lc->cmdU.loopInfo.cmdLoop = cmdLoop;
@@ -111,8 +176,8 @@ Command* newLoopCommand(Expression* loopExpression, Command* cmdLoop) {
 }
 
 // Read Command Node Constructor
-Command* newReadCommand(IdentifierList* identifiers) {
-    Command* rc = (Command*)malloc(sizeof(Command));
+Command* newReadCommand(Arena* arena, IdentifierList* identifiers) {
+    Command* rc = (Command*)arenaAlloc(arena, COMMAND_SIZE(readInfo));
     rc->type = Read;
     rc->cmdU.readInfo.identifiers = identifiers;
     rc->next = NULL;
@@ -120,8 +185,8 @@ Command* newReadCommand(IdentifierList* identifiers) {
 }
 
 // Write Command Node Constructor
-Command* newWriteCommand(Expression* expressionList) {
-    Command* wc = (Command*)malloc(sizeof(Command));
+Command* newWriteCommand(Arena* arena, Expression* expressionList) {
+    Command* wc = (Command*)arenaAlloc(arena, COMMAND_SIZE(writeInfo));
     wc->type = Write;
     wc->cmdU.writeInfo.expressionList = expressionList;
     wc->next = NULL;
@@ -129,38 +194,41 @@ Command* newWriteCommand(Expression* expressionList) {
 }
 
 // Binary Expression Node Constructor
-Expression* newBinaryExpression(Expression* left, Operator operator, Expression* right) {
-    Expression* e = (Expression*)malloc(sizeof(Expression));
+Expression* newBinaryExpression(Arena* arena, Expression* left, Operator operator, Expression* right) {
+    Expression* e = (Expression*)arenaAlloc(arena, EXPRESSION_SIZE(binExpr));
     e->type = Binary;
     e->exprU.binExpr.left = left;
-    e->exprU.binExpr.operator = operator;
+    e->operator = operator;
     e->exprU.binExpr.right = right;
     e->next = NULL;
     return e;
 }
 
 // Unary Expression Node Constructor
-Expression* newUnaryExpression(Operator operator, Expression* right) {
-    Expression* e = (Expression*)malloc(sizeof(Expression));
+Expression* newUnaryExpression(Arena* arena, Operator operator, Expression* right) {
+    Expression* e = (Expression*)arenaAlloc(arena, EXPRESSION_SIZE(unyExpr));
     e->type = Unary;
-    e->exprU.unyExpr.operator = operator;
+    e->operator = operator;
     e->exprU.unyExpr.right = right;
     e->next = NULL;
     return e;
 }
 
 // Variable Expression Node Constructor
-Expression* newVariableExpression(char* identifier) {
-    Expression* e = (Expression*)malloc(sizeof(Expression));
+Expression* newVariableExpression(Arena* arena, char* identifier) {
+    Expression* e = (Expression*)arenaAlloc(arena, EXPRESSION_SIZE(varExpr));
     e->type = Var;
     e->exprU.varExpr.identifier = identifier;
+    e->exprU.varExpr.binding.level = 0;
+    e->exprU.varExpr.binding.offset = 0;
+    e->exprU.varExpr.valueType = Int;
     e->next = NULL;
     return e;
 }
 
 // Constant Integer Expression Node Constructor
-Expression* newConstantIntegerExpression(int number) {
-    Expression* e = (Expression*)malloc(sizeof(Expression));
+Expression* newConstantIntegerExpression(Arena* arena, int number) {
+    Expression* e = (Expression*)arenaAlloc(arena, EXPRESSION_SIZE(intExpr));
     e->type = ConstInt;
     e->exprU.intExpr.number = number;
     e->next = NULL;
@@ -168,8 +236,8 @@ Expression* newConstantIntegerExpression(int number) {
 }
 
 // Constant Boolean Expression Node Constructor
-Expression* newConstantBooleanExpression(BooleanValue boolean) {
-    Expression* e = (Expression*)malloc(sizeof(Expression));
+Expression* newConstantBooleanExpression(Arena* arena, BooleanValue boolean) {
+    Expression* e = (Expression*)arenaAlloc(arena, EXPRESSION_SIZE(boolExpr));
     e->type = ConstBool;
     e->exprU.boolExpr.boolean = boolean;
     e->next = NULL;
@@ -177,196 +245,108 @@ Expression* newConstantBooleanExpression(BooleanValue boolean) {
 }
 
 // Function Call Expression Node Constructor
-Expression* newFunctionCallExpression(char* identifier, Expression* expressionList) {
-    Expression* e = (Expression*)malloc(sizeof(Expression));
+Expression* newFunctionCallExpression(Arena* arena, char* identifier, Expression* expressionList) {
+    Expression* e = (Expression*)arenaAlloc(arena, EXPRESSION_SIZE(funCallExpr));
     e->type = FuncCall;
     e->exprU.funCallExpr.identifier = identifier;
     e->exprU.funCallExpr.expressionList = expressionList;
+    e->exprU.funCallExpr.target = NULL;
     e->next = NULL;
     return e;
 }
 
-// - Add to List Functions ----------------
+// - Chain Constructors -------------------
 
-// Variable Declaration AddToList Function
-VarDeclaration* addVarDeclaration(VarDeclaration* list, VarDeclaration* newVarDecl) {
-    if(!list) return newVarDecl;
-    VarDeclaration* it = list;
-    while(it->next) it = it->next;
-    it->next = newVarDecl;
-    return list;
-}
+// The first element may already be a list (e.g. "var a, b: integer"
+// or a nested "begin ... end"), so the tail is found by walking it once
 
-// Identifier AddToList Function
-IdentifierList* addIdentifier(IdentifierList* list, IdentifierList* newId) {
-    if(!list) return newId;
-    IdentifierList* it = list;
-    while(it->next) it = it->next;
-    it->next = newId;
-    return list;
+// Variable Declaration Chain Constructor
+VarDeclarationChain newVarDeclarationChain(VarDeclaration* first) {
+    VarDeclarationChain chain = {first, first};
+    while (chain.tail && chain.tail->next) chain.tail = chain.tail->next;
+    return chain;
 }
 
-// Subroutine Declaration AddToList Function
-SubRotDeclaration* addSubRotDeclaration(SubRotDeclaration* list, SubRotDeclaration* newSubRotDecl) {
-    if(!list) return newSubRotDecl;
-    SubRotDeclaration* it = list;
-    while(it->next) it = it->next;
-    it->next = newSubRotDecl;
-    return list;
+// Identifier Chain Constructor
+IdentifierChain newIdentifierChain(IdentifierList* first) {
+    IdentifierChain chain = {first, first};
+    while (chain.tail && chain.tail->next) chain.tail = chain.tail->next;
+    return chain;
 }
 
-// Command AddToList Function
-Command* addCommand(Command* list, Command* newCmd) {
-    if(!list) return newCmd;
-    Command* it = list;
-    while(it->next) it = it->next;
-    it->next = newCmd;
-    return list;
+// Subroutine Declaration Chain Constructor
+SubRotDeclarationChain newSubRotDeclarationChain(SubRotDeclaration* first) {
+    SubRotDeclarationChain chain = {first, first};
+    while (chain.tail && chain.tail->next) chain.tail = chain.tail->next;
+    return chain;
 }
 
-// Expression AddToList Function
-Expression* addExpression(Expression* list, Expression* newExpr) {
-    if(!list) return newExpr;
-    Expression* it = list;
-    while(it->next) it = it->next;
-    it->next = newExpr;
-    return list;
+// Command Chain Constructor
+CommandChain newCommandChain(Command* first) {
+    CommandChain chain = {first, first};
+    while (chain.tail && chain.tail->next) chain.tail = chain.tail->next;
+    return chain;
 }
 
-// - Free ---------------------------------
-
-// Free Abstract Syntax Tree Function
-void freeAstRoot(Program* r) {
-    if (!r) return;
-    freeProgram(r);
+// Expression Chain Constructor
+ExpressionChain newExpressionChain(Expression* first) {
+    ExpressionChain chain = {first, first};
+    while (chain.tail && chain.tail->next) chain.tail = chain.tail->next;
+    return chain;
 }
 
-// Free Program Node Function
-void freeProgram(Program* p) {
-    if (!p) return;
-    free(p->identifier);
-    freeBlock(p->block);
-    free(p);
-}
+// - Add to List Functions ----------------
 
-// Free Block Node Function
-void freeBlock(Block* b) {
-    if (!b) return;
-    freeVarDeclaration(b->varDeclarations);
-    freeSubRotDeclaration(b->subRotDeclarations);
-    freeCommand(b->commandList);
-    free(b);
+// Variable Declaration AddToList Function
+VarDeclarationChain addVarDeclaration(VarDeclarationChain chain, VarDeclaration* newVarDecl) {
+    if (!chain.head) return newVarDeclarationChain(newVarDecl);
+    if (!newVarDecl) return chain;
+    chain.tail->next = newVarDecl;
+    chain.tail = newVarDeclarationChain(newVarDecl).tail;
+    return chain;
 }
 
-// Free Var Declaration Node Function
-void freeVarDeclaration(VarDeclaration* vd) {
-    while (vd) {
-        VarDeclaration* next = vd->next;
-        free(vd->identifier);
-        free(vd);
-        vd = next;
-    }
+// Identifier AddToList Function
+IdentifierChain addIdentifier(IdentifierChain chain, IdentifierList* newId) {
+    if (!chain.head) return newIdentifierChain(newId);
+    if (!newId) return chain;
+    chain.tail->next = newId;
+    chain.tail = newIdentifierChain(newId).tail;
+    return chain;
 }
 
-// Free Identifier Node Function
-void freeIdentifierList(IdentifierList* il) {
-    while (il) {
-        IdentifierList* next = il->next;
-        free(il->identifier);
-        free(il);
-        il = next;
-    }
+// Subroutine Declaration AddToList Function
+SubRotDeclarationChain addSubRotDeclaration(SubRotDeclarationChain chain, SubRotDeclaration* newSubRotDecl) {
+    if (!chain.head) return newSubRotDeclarationChain(newSubRotDecl);
+    if (!newSubRotDecl) return chain;
+    chain.tail->next = newSubRotDecl;
+    chain.tail = newSubRotDeclarationChain(newSubRotDecl).tail;
+    return chain;
 }
 
-// Free Subroutine Declaration Node Function
-void freeSubRotDeclaration(SubRotDeclaration* srd) {
-    while (srd) {
-        SubRotDeclaration* next = srd->next;
-        switch (srd->type) {
-            case Proc:
-                free(srd->subrotU.procInfo.identifier);
-                freeVarDeclaration(srd->subrotU.procInfo.formParams);
-                freeSubRotBlock(srd->subrotU.procInfo.subRotBlock);
-                break;
-            case Func:
-                free(srd->subrotU.funcInfo.identifier);
-                freeVarDeclaration(srd->subrotU.funcInfo.formParams);
-                freeSubRotBlock(srd->subrotU.funcInfo.subRotBlock);
-                break;
-        }
-        free(srd);
-        srd = next;
-    }
+// Command AddToList Function
+CommandChain addCommand(CommandChain chain, Command* newCmd) {
+    if (!chain.head) return newCommandChain(newCmd);
+    if (!newCmd) return chain;
+    chain.tail->next = newCmd;
+    chain.tail = newCommandChain(newCmd).tail;
+    return chain;
 }
 
-// Free Subroutine Block Node Function
-void freeSubRotBlock(SubRotBlock* srb) {
-    freeVarDeclaration(srb->varDeclarations);
-    freeCommand(srb->commands);
-    free(srb);
+// Expression AddToList Function
+ExpressionChain addExpression(ExpressionChain chain, Expression* newExpr) {
+    if (!chain.head) return newExpressionChain(newExpr);
+    if (!newExpr) return chain;
+    chain.tail->next = newExpr;
+    chain.tail = newExpressionChain(newExpr).tail;
+    return chain;
 }
 
-// Free Command Node Function
-void freeCommand(Command* c) {
-    while (c) {
-        Command* next = c->next;
-        switch (c->type) {
-            case Assign:
-                free(c->cmdU.assignInfo.identifier);
-                freeExpression(c->cmdU.assignInfo.expression);
-                break;
-            case ProcCall:
-                free(c->cmdU.procCallInfo.identifier);
-                freeExpression(c->cmdU.procCallInfo.expressionList);
-                break;
-            case Conditional:
-                freeExpression(c->cmdU.condInfo.condExpression);
-                freeCommand(c->cmdU.condInfo.cmdIf);
-                freeCommand(c->cmdU.condInfo.cmdElse);
-                break;
-            case Loop:
-                freeExpression(c->cmdU.loopInfo.loopExpression);
-                freeCommand(c->cmdU.loopInfo.cmdLoop);
-                break;
-            case Read:
-                freeIdentifierList(c->cmdU.readInfo.identifiers);
-                break;
-            case Write:
-                freeExpression(c->cmdU.writeInfo.expressionList);
-                break;
-        }
-        free(c);
-        c = next;
-    }
-}
+// - Free ---------------------------------
 
-// Free Expression Node Function
-void freeExpression(Expression* e) {
-    while (e) {
-        Expression* next = e->next;
-        switch (e->type) {
-            case Binary:
-                freeExpression(e->exprU.binExpr.left);
-                freeExpression(e->exprU.binExpr.right);
-                break;
-            case Unary:
-                freeExpression(e->exprU.unyExpr.right);
-                break;
-            case Var:
-                free(e->exprU.varExpr.identifier);
-                break;
-            case FuncCall:
-                free(e->exprU.funCallExpr.identifier);
-                freeExpression(e->exprU.funCallExpr.expressionList);
-                break;
-            case ConstInt:
-                break;
-            case ConstBool:
-                break;
-        }
-        free(e);
-        e = next;
-    }
+// Free Abstract Syntax Tree Function: every node lives in the AST arena
+void freeAstRoot(Arena* astArena) {
+    releaseArena(astArena);
 }
 
 // - Print --------------------------------
@@ -570,7 +550,7 @@ void printExpression(const Expression* expression, FILE* out, int level) {
                 fprintf(out, "[Binary Expr]\n");
                 printIndent(out, level + 1);
                 fprintf(out, "Op: ");
-                switch (expression->exprU.binExpr.operator) {
+                switch (expression->operator) {
                     case Equal: fprintf(out, "=\n"); break;
                     case Different: fprintf(out, "<>\n"); break;
                     case Less: fprintf(out, "<\n"); break;
@@ -597,7 +577,7 @@ void printExpression(const Expression* expression, FILE* out, int level) {
                 fprintf(out, "[Unary Expr]\n");
                 printIndent(out, level + 1);
                 fprintf(out, "Op: ");
-                switch (expression->exprU.unyExpr.operator) {
+                switch (expression->operator) {
                     case Minus: fprintf(out, "-\n"); break;
                     case Plus: fprintf(out, "+\n"); break;
                     case Not: fprintf(out, "NOT\n"); break;
@@ -2,6 +2,8 @@
 #define RASCAL_AST_H
 
 #include <stdio.h>
+#include "arena.h"
+#include "intern_table.h"
 
 // Foward Declarations
 typedef struct Program Program;
@@ -21,6 +23,14 @@ typedef enum {Binary, Unary, Var, ConstInt, ConstBool, FuncCall} exprType;
 typedef enum {Equal, Different, Less, LessEqual, Greater, GreaterEqual, Plus, Minus, Or, Multiplication, Division, And, Not} Operator;
 typedef enum {BoolFalse, BoolTrue} BooleanValue;
 
+// Identifier Token: slice of the source buffer, not NUL terminated.
+// Every identifier stored in the AST is interned (see intern_table.h)
+typedef struct {const char* text; int length;} Slice;
+
+// Storage of a variable, parameter or function result, resolved by the
+// semantic analysis: MEPA lexical level and offset in the frame
+typedef struct {int level; int offset;} Binding;
+
 // Program Node
 struct Program {
     char* identifier;
@@ -43,6 +53,7 @@ struct VarDeclaration {
 // Identifier List Node
 struct IdentifierList {
     char* identifier;
+    Binding binding;                                // Read targets, set by the semantic analysis
     struct IdentifierList* next;                    // To link in the list
 };
 
@@ -53,6 +64,9 @@ struct SubRotDeclaration {
         struct {char* identifier; struct VarDeclaration* formParams /*List*/; struct SubRotBlock* subRotBlock;} procInfo;                        // Procedure
         struct {char* identifier; struct VarDeclaration* formParams /*List*/; varType returnType; struct SubRotBlock* subRotBlock;} funcInfo;    // Function
     } subrotU;
+    int label;                                                                                                                                   // Entry label, set by the code generator
+    int calls;                                                                                                                                   // Call sites in reachable code, set by the dead code pass
+    int pure;                                                                                                                                    // No effect and always returns, set by the semantic analysis
     struct SubRotDeclaration* next;                                                                                                              // To link in the list
 };
 
@@ -62,72 +76,99 @@ struct SubRotBlock {
     struct Command* commands /*List*/;
 };
 
+// Command and Expression nodes are allocated with room for the union
+// member of their own kind only, so a node must never be copied whole
+// or turned into a kind with a larger member (changeExpressionKind
+// checks the latter). Links come before the
+// union to keep them inside every allocation. Bindings, value types
+// and call targets are filled in by the semantic analysis, and code
+// generation relies on them.
+
 // Command List Node
 struct Command {
     cmdType type;
+    struct Command* next;                                                                                       // To link in the list
     union {
-        struct {char* identifier; struct Expression* expression;} assignInfo;                                   // Assign Command
-        struct {char* identifier; struct Expression* expressionList;} procCallInfo;                             // Procedure Call Command
+        struct {char* identifier; struct Expression* expression; Binding binding;} assignInfo;                  // Assign Command
+        struct {char* identifier; struct Expression* expressionList; struct SubRotDeclaration* target;} procCallInfo;   // Procedure Call Command
         struct {struct Expression* condExpression; struct Command* cmdIf; struct Command* cmdElse;} condInfo;   // Conditional Command
         struct {struct Expression* loopExpression; struct Command* cmdLoop;} loopInfo;                          // Looping Command
         struct {struct IdentifierList* identifiers /*List*/;} readInfo;                                         // Read Command
         struct {struct Expression* expressionList;} writeInfo;                                                  // Write Command
     } cmdU;
-    struct Command* next;                                                                                       // To link in the list
 };
 
 // Expression List Node
 struct Expression {
     exprType type;
+    Operator operator;                                                                                          // Binary and Unary Expressions
+    struct Expression* next;                                                                                    // To link in the list
     union {
-        struct {struct Expression* left; Operator operator; struct Expression* right;} binExpr;                 // Binary Expression
-        struct {Operator operator; struct Expression* right;} unyExpr;                                          // Unary Expression
-        struct {char* identifier;} varExpr;                                                                     // Variable Expression
+        struct {struct Expression* left; struct Expression* right;} binExpr;                                    // Binary Expression
+        struct {struct Expression* right;} unyExpr;                                                             // Unary Expression
+        struct {char* identifier; Binding binding; varType valueType;} varExpr;                                 // Variable Expression
         struct {int number;} intExpr;                                                                           // Constant Integer Expression
         struct {BooleanValue boolean;} boolExpr;                                                                // Constant Boolean Expression
-        struct {char* identifier; struct Expression* expressionList;} funCallExpr;                              // Function Call Expression
+        struct {char* identifier; struct Expression* expressionList; struct SubRotDeclaration* target;} funCallExpr;    // Function Call Expression
     } exprU;
-    struct Expression* next;                                                                                    // To link in the list
 };
 
+// Token Conversion
+char* sliceToIdentifier(InternTable* identifiers, Slice slice);
+
+// Type of an expression annotated by the semantic analysis
+varType expressionType(const Expression* expression);
+
+// Turns an expression node into another kind in place, asserting that
+// the new union member fits the node (its current kind bounds its
+// allocation). Passes rewriting nodes in place go through this
+void changeExpressionKind(Expression* expression, exprType type);
+
+// List Chains: head and tail of a list under construction, so the
+// parser appends in constant time instead of walking to the end
+typedef struct {VarDeclaration* head; VarDeclaration* tail;} VarDeclarationChain;
+typedef struct {IdentifierList* head; IdentifierList* tail;} IdentifierChain;
+typedef struct {SubRotDeclaration* head; SubRotDeclaration* tail;} SubRotDeclarationChain;
+typedef struct {Command* head; Command* tail;} CommandChain;
+typedef struct {Expression* head; Expression* tail;} ExpressionChain;
+
 // Node Constructors
-Program* newProgram(char* identifier, Block* block);
-Block* newBlock(VarDeclaration* varDeclarations, SubRotDeclaration* subRotDeclarations, Command* commandList);
-VarDeclaration* newVarDeclaration(varType type, char* identifier);
-IdentifierList* newIdentifierList(char* identifier);
-SubRotDeclaration* newProcDeclaration(char* identifier, VarDeclaration* formParams, SubRotBlock* subRotBlock);
-SubRotDeclaration* newFuncDeclaration(char* identifier, VarDeclaration* formParams, varType returnType, SubRotBlock* subRotBlock);
-SubRotBlock* newSubRotBlock(VarDeclaration* varDeclarations, Command* commands);
-Command* newAssignCommand(char* identifier, Expression* expression);
-Command* newProcCallCommand(char* identifier, Expression* expressionList);
-Command* newCondCommand(Expression* condExpression, Command* cmdIf, Command* cmdElse);
-Command* newLoopCommand(Expression* loopExpression, Command* cmdLoop);
-Command* newReadCommand(IdentifierList* identifiers);
-Command* newWriteCommand(Expression* expressionList);
-Expression* newBinaryExpression(Expression* left, Operator operator, Expression* right);
-Expression* newUnaryExpression(Operator operator, Expression* right);
-Expression* newVariableExpression(char* identifier);
-Expression* newConstantIntegerExpression(int number);
-Expression* newConstantBooleanExpression(BooleanValue boolean);
-Expression* newFunctionCallExpression(char* identifier, Expression* expressionList);
+Program* newProgram(Arena* arena, char* identifier, Block* block);
+Block* newBlock(Arena* arena, VarDeclaration* varDeclarations, SubRotDeclaration* subRotDeclarations, Command* commandList);
+VarDeclaration* newVarDeclaration(Arena* arena, varType type, char* identifier);
+IdentifierList* newIdentifierList(Arena* arena, char* identifier);
+SubRotDeclaration* newProcDeclaration(Arena* arena, char* identifier, VarDeclaration* formParams, SubRotBlock* subRotBlock);
+SubRotDeclaration* newFuncDeclaration(Arena* arena, char* identifier, VarDeclaration* formParams, varType returnType, SubRotBlock* subRotBlock);
+SubRotBlock* newSubRotBlock(Arena* arena, VarDeclaration* varDeclarations, Command* commands);
+Command* newAssignCommand(Arena* arena, char* identifier, Expression* expression);
+Command* newProcCallCommand(Arena* arena, char* identifier, Expression* expressionList);
+Command* newCondCommand(Arena* arena, Expression* condExpression, Command* cmdIf, Command* cmdElse);
+Command* newLoopCommand(Arena* arena, Expression* loopExpression, Command* cmdLoop);
+Command* newReadCommand(Arena* arena, IdentifierList* identifiers);
+Command* newWriteCommand(Arena* arena, Expression* expressionList);
+Expression* newBinaryExpression(Arena* arena, Expression* left, Operator operator, Expression* right);
+Expression* newUnaryExpression(Arena* arena, Operator operator, Expression* right);
+Expression* newVariableExpression(Arena* arena, char* identifier);
+Expression* newConstantIntegerExpression(Arena* arena, int number);
+Expression* newConstantBooleanExpression(Arena* arena, BooleanValue boolean);
+Expression* newFunctionCallExpression(Arena* arena, char* identifier, Expression* expressionList);
+
+// Chain Constructors
+VarDeclarationChain newVarDeclarationChain(VarDeclaration* first);
+IdentifierChain newIdentifierChain(IdentifierList* first);
+SubRotDeclarationChain newSubRotDeclarationChain(SubRotDeclaration* first);
+CommandChain newCommandChain(Command* first);
+ExpressionChain newExpressionChain(Expression* first);
 
 // Add to Linked List Functions
-VarDeclaration* addVarDeclaration(VarDeclaration* list, VarDeclaration* newVarDecl);
-IdentifierList* addIdentifier(IdentifierList* list, IdentifierList* newId);
-SubRotDeclaration* addSubRotDeclaration(SubRotDeclaration* list, SubRotDeclaration* newSubRotDecl);
-Command* addCommand(Command* list, Command* newCmd);
-Expression* addExpression(Expression* list, Expression* newExpr);
+VarDeclarationChain addVarDeclaration(VarDeclarationChain chain, VarDeclaration* newVarDecl);
+IdentifierChain addIdentifier(IdentifierChain chain, IdentifierList* newId);
+SubRotDeclarationChain addSubRotDeclaration(SubRotDeclarationChain chain, SubRotDeclaration* newSubRotDecl);
+CommandChain addCommand(CommandChain chain, Command* newCmd);
+ExpressionChain addExpression(ExpressionChain chain, Expression* newExpr);
 
 // Free Functions
-void freeAstRoot(Program* r);
-void freeProgram(Program* p);
-void freeBlock(Block* b);
-void freeVarDeclaration(VarDeclaration* vd);
-void freeIdentifierList(IdentifierList* il);
-void freeSubRotDeclaration(SubRotDeclaration* srd);
-void freeSubRotBlock(SubRotBlock* srb);
-void freeCommand(Command* c);
-void freeExpression(Expression* e);
+void freeAstRoot(Arena* astArena);
 
 // Print Functions
 void printAstRoot(Program* ast_root, FILE* out);
@@ -140,7 +181,4 @@ void printSubRotBlock(const SubRotBlock* subRotBlock, FILE* out, int level);
 void printCommand(const Command* command, FILE* out, int level);
 void printExpression(const Expression* expression, FILE* out, int level);
 
-/* Global Variable for AST Root */
-extern Program* ast_root;
-
 #endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "rascal_build.h"
+#include "compilation.h"
+
+// Every builder takes the flat branch when comp->flatAst is set
+
+static uint32_t nameNumber(Compilation* comp, Slice identifier) {
+    return internIdentifierNumber(&comp->identifiers, identifier.text, identifier.length);
+}
+
+static AstRef nodeRef(void* node) {
+    AstRef ref = AST_NONE;
+    ref.node = node;
+    return ref;
+}
+
+static AstRef rowRef(FlatIndex row) {
+    AstRef ref = AST_NONE;
+    ref.row = row;
+    return ref;
+}
+
+// - Program Builders ---------------------
+
+// Program: the root of the compilation
+void buildProgram(Compilation* comp, Slice identifier, AstRef block) {
+    if (comp->flatAst) {
+        comp->flat.name = nameNumber(comp, identifier);
+        comp->flat.complete = 1;
+        return;
+    }
+    comp->astRoot = newProgram(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier), block.node);
+}
+
+// Block: the flat layout keeps the program block in the tables
+AstRef buildBlock(Compilation* comp, AstRef varDeclarations, AstRef subRotDeclarations, AstRef commandList) {
+    if (comp->flatAst) {
+        comp->flat.globals = varDeclarations.row;
+        comp->flat.subroutineList = subRotDeclarations.row;
+        comp->flat.commandList = commandList.row;
+        return AST_NONE;
+    }
+    return nodeRef(newBlock(&comp->astArena, varDeclarations.node, subRotDeclarations.node, commandList.node));
+}
+
+// Declarations of the identifiers of a list, all of one type. Flat
+// identifiers already are variable rows
+AstRef buildVarDeclarations(Compilation* comp, AstChain identifiers, varType type) {
+    if (comp->flatAst) {
+        for (FlatIndex v = identifiers.head.row; v; v = comp->flat.variables[v].next)
+            comp->flat.variables[v].type = (uint8_t) type;
+        return identifiers.head;
+    }
+
+    VarDeclarationChain list = newVarDeclarationChain(NULL);
+    for (IdentifierList* it = identifiers.head.node; it; it = it->next)
+        list = addVarDeclaration(list, newVarDeclaration(&comp->astArena, type, it->identifier));
+    return nodeRef(list.head);
+}
+
+AstRef buildIdentifier(Compilation* comp, Slice identifier) {
+    if (comp->flatAst) return rowRef(newFlatVariable(&comp->flat, nameNumber(comp, identifier)));
+    return nodeRef(newIdentifierList(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier)));
+}
+
+// Subroutines: the flat body row becomes the subroutine row
+AstRef buildProcDeclaration(Compilation* comp, Slice identifier, AstRef formParams, AstRef subRotBlock) {
+    if (comp->flatAst) {
+        FlatSubroutine* s = &comp->flat.subroutines[subRotBlock.row];
+        s->name = nameNumber(comp, identifier);
+        s->kind = Proc;
+        s->params = formParams.row;
+        return subRotBlock;
+    }
+    return nodeRef(newProcDeclaration(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier),
+                                      formParams.node, subRotBlock.node));
+}
+
+AstRef buildFuncDeclaration(Compilation* comp, Slice identifier, AstRef formParams, varType returnType, AstRef subRotBlock) {
+    if (comp->flatAst) {
+        FlatSubroutine* s = &comp->flat.subroutines[subRotBlock.row];
+        s->name = nameNumber(comp, identifier);
+        s->kind = Func;
+        s->returnType = (uint8_t) returnType;
+        s->params = formParams.row;
+        return subRotBlock;
+    }
+    return nodeRef(newFuncDeclaration(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier),
+                                      formParams.node, returnType, subRotBlock.node));
+}
+
+AstRef buildSubRotBlock(Compilation* comp, AstRef varDeclarations, AstRef commands) {
+    if (comp->flatAst) return rowRef(newFlatSubroutine(&comp->flat, varDeclarations.row, commands.row));
+    return nodeRef(newSubRotBlock(&comp->astArena, varDeclarations.node, commands.node));
+}
+
+// - Command Builders ---------------------
+
+AstRef buildAssignCommand(Compilation* comp, Slice identifier, AstRef expression) {
+    if (comp->flatAst) return rowRef(newFlatCommand(&comp->flat, Assign, nameNumber(comp, identifier), expression.row, 0));
+    return nodeRef(newAssignCommand(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier), expression.node));
+}
+
+AstRef buildProcCallCommand(Compilation* comp, Slice identifier, AstRef expressionList) {
+    if (comp->flatAst) return rowRef(newFlatCommand(&comp->flat, ProcCall, nameNumber(comp, identifier), expressionList.row, 0));
+    return nodeRef(newProcCallCommand(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier), expressionList.node));
+}
+
+AstRef buildCondCommand(Compilation* comp, AstRef condExpression, AstRef cmdIf, AstRef cmdElse) {
+    if (comp->flatAst) return rowRef(newFlatCommand(&comp->flat, Conditional, condExpression.row, cmdIf.row, cmdElse.row));
+    return nodeRef(newCondCommand(&comp->astArena, condExpression.node, cmdIf.node, cmdElse.node));
+}
+
+AstRef buildLoopCommand(Compilation* comp, AstRef loopExpression, AstRef cmdLoop) {
+    if (comp->flatAst) return rowRef(newFlatCommand(&comp->flat, Loop, loopExpression.row, cmdLoop.row, 0));
+    return nodeRef(newLoopCommand(&comp->astArena, loopExpression.node, cmdLoop.node));
+}
+
+// Read: flat targets are variable expressions, resolved like any other
+AstRef buildReadCommand(Compilation* comp, AstChain identifiers) {
+    if (comp->flatAst) {
+        FlatAst* ast = &comp->flat;
+        FlatIndex first = 0, last = 0;
+        for (FlatIndex v = identifiers.head.row; v; v = ast->variables[v].next) {
+            FlatIndex e = newFlatExpression(ast, Var, 0, ast->variables[v].name, 0);
+            if (last) ast->expressions.next[last] = e;
+            else first = e;
+            last = e;
+        }
+        return rowRef(newFlatCommand(ast, Read, first, 0, 0));
+    }
+    return nodeRef(newReadCommand(&comp->astArena, identifiers.head.node));
+}
+
+AstRef buildWriteCommand(Compilation* comp, AstRef expressionList) {
+    if (comp->flatAst) return rowRef(newFlatCommand(&comp->flat, Write, expressionList.row, 0, 0));
+    return nodeRef(newWriteCommand(&comp->astArena, expressionList.node));
+}
+
+// - Expression Builders ------------------
+
+AstRef buildBinaryExpression(Compilation* comp, AstRef left, Operator operator, AstRef right) {
+    if (comp->flatAst) return rowRef(newFlatExpression(&comp->flat, Binary, operator, left.row, right.row));
+    return nodeRef(newBinaryExpression(&comp->astArena, left.node, operator, right.node));
+}
+
+AstRef buildUnaryExpression(Compilation* comp, Operator operator, AstRef right) {
+    if (comp->flatAst) return rowRef(newFlatExpression(&comp->flat, Unary, operator, 0, right.row));
+    return nodeRef(newUnaryExpression(&comp->astArena, operator, right.node));
+}
+
+AstRef buildVariableExpression(Compilation* comp, Slice identifier) {
+    if (comp->flatAst) return rowRef(newFlatExpression(&comp->flat, Var, 0, nameNumber(comp, identifier), 0));
+    return nodeRef(newVariableExpression(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier)));
+}
+
+AstRef buildConstantIntegerExpression(Compilation* comp, int number) {
+    if (comp->flatAst) return rowRef(newFlatExpression(&comp->flat, ConstInt, 0, (FlatIndex) number, 0));
+    return nodeRef(newConstantIntegerExpression(&comp->astArena, number));
+}
+
+AstRef buildConstantBooleanExpression(Compilation* comp, BooleanValue boolean) {
+    if (comp->flatAst) return rowRef(newFlatExpression(&comp->flat, ConstBool, 0, (FlatIndex) boolean, 0));
+    return nodeRef(newConstantBooleanExpression(&comp->astArena, boolean));
+}
+
+AstRef buildFunctionCallExpression(Compilation* comp, Slice identifier, AstRef expressionList) {
+    if (comp->flatAst) return rowRef(newFlatExpression(&comp->flat, FuncCall, 0, expressionList.row, nameNumber(comp, identifier)));
+    return nodeRef(newFunctionCallExpression(&comp->astArena, sliceToIdentifier(&comp->identifiers, identifier), expressionList.node));
+}
+
+// - List Builders ------------------------
+
+// Link to the next flat row of a list
+static FlatIndex* flatNext(FlatAst* ast, AstListKind kind, FlatIndex row) {
+    switch (kind) {
+        case LIST_VARS:
+        case LIST_IDENTIFIERS: return &ast->variables[row].next;
+        case LIST_SUBROUTINES: return &ast->subroutines[row].next;
+        case LIST_COMMANDS:    return &ast->commands.next[row];
+        default:               return &ast->expressions.next[row];
+    }
+}
+
+static AstChain flatChain(FlatAst* ast, AstListKind kind, FlatIndex first) {
+    FlatIndex tail = first;
+    while (tail && *flatNext(ast, kind, tail)) tail = *flatNext(ast, kind, tail);
+    AstChain chain = {rowRef(first), rowRef(tail)};
+    return chain;
+}
+
+static AstChain linkedChain(void* head, void* tail) {
+    AstChain chain = {nodeRef(head), nodeRef(tail)};
+    return chain;
+}
+
+// Starts a list with its first element (or elements)
+AstChain buildChain(Compilation* comp, AstListKind kind, AstRef first) {
+    if (comp->flatAst) return flatChain(&comp->flat, kind, first.row);
+    return buildAppend(comp, kind, linkedChain(NULL, NULL), first);
+}
+
+// Appends an element (or a list) to a list in constant time
+AstChain buildAppend(Compilation* comp, AstListKind kind, AstChain chain, AstRef element) {
+    if (comp->flatAst) {
+        if (!chain.head.row) return flatChain(&comp->flat, kind, element.row);
+        if (!element.row) return chain;
+        *flatNext(&comp->flat, kind, chain.tail.row) = element.row;
+        chain.tail = flatChain(&comp->flat, kind, element.row).tail;
+        return chain;
+    }
+
+    switch (kind) {
+        case LIST_VARS: {
+            VarDeclarationChain typed = {chain.head.node, chain.tail.node};
+            typed = addVarDeclaration(typed, element.node);
+            return linkedChain(typed.head, typed.tail);
+        }
+        case LIST_IDENTIFIERS: {
+            IdentifierChain typed = {chain.head.node, chain.tail.node};
+            typed = addIdentifier(typed, element.node);
+            return linkedChain(typed.head, typed.tail);
+        }
+        case LIST_SUBROUTINES: {
+            SubRotDeclarationChain typed = {chain.head.node, chain.tail.node};
+            typed = addSubRotDeclaration(typed, element.node);
+            return linkedChain(typed.head, typed.tail);
+        }
+        case LIST_COMMANDS: {
+            CommandChain typed = {chain.head.node, chain.tail.node};
+            typed = addCommand(typed, element.node);
+            return linkedChain(typed.head, typed.tail);
+        }
+        default: {
+            ExpressionChain typed = {chain.head.node, chain.tail.node};
+            typed = addExpression(typed, element.node);
+            return linkedChain(typed.head, typed.tail);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef RASCAL_BUILD_H
+#define RASCAL_BUILD_H
+
+#include "rascal_ast.h"
+#include "rascal_flat.h"
+
+typedef struct Compilation Compilation;
+
+// Tree building for the parser, in the layout the compilation asks for
+// (comp->flatAst): linked nodes (rascal_ast.h) or flat rows
+// (rascal_flat.h). Grammar actions only pass these handles around.
+
+// Node or row under construction
+typedef union AstRef {
+    void* node;
+    FlatIndex row;
+} AstRef;
+
+// No node, in both layouts (all bits zero)
+#define AST_NONE ((AstRef) {NULL})
+
+// Head and tail of a list under construction
+typedef struct AstChain {
+    AstRef head;
+    AstRef tail;
+} AstChain;
+
+// List Kinds
+typedef enum {LIST_VARS, LIST_IDENTIFIERS, LIST_SUBROUTINES, LIST_COMMANDS, LIST_EXPRESSIONS} AstListKind;
+
+// Program Builders
+void buildProgram(Compilation* comp, Slice identifier, AstRef block);
+AstRef buildBlock(Compilation* comp, AstRef varDeclarations, AstRef subRotDeclarations, AstRef commandList);
+AstRef buildVarDeclarations(Compilation* comp, AstChain identifiers, varType type);
+AstRef buildIdentifier(Compilation* comp, Slice identifier);
+AstRef buildProcDeclaration(Compilation* comp, Slice identifier, AstRef formParams, AstRef subRotBlock);
+AstRef buildFuncDeclaration(Compilation* comp, Slice identifier, AstRef formParams, varType returnType, AstRef subRotBlock);
+AstRef buildSubRotBlock(Compilation* comp, AstRef varDeclarations, AstRef commands);
+
+// Command Builders
+AstRef buildAssignCommand(Compilation* comp, Slice identifier, AstRef expression);
+AstRef buildProcCallCommand(Compilation* comp, Slice identifier, AstRef expressionList);
+AstRef buildCondCommand(Compilation* comp, AstRef condExpression, AstRef cmdIf, AstRef cmdElse);
+AstRef buildLoopCommand(Compilation* comp, AstRef loopExpression, AstRef cmdLoop);
+AstRef buildReadCommand(Compilation* comp, AstChain identifiers);
+AstRef buildWriteCommand(Compilation* comp, AstRef expressionList);
+
+// Expression Builders
+AstRef buildBinaryExpression(Compilation* comp, AstRef left, Operator operator, AstRef right);
+AstRef buildUnaryExpression(Compilation* comp, Operator operator, AstRef right);
+AstRef buildVariableExpression(Compilation* comp, Slice identifier);
+AstRef buildConstantIntegerExpression(Compilation* comp, int number);
+AstRef buildConstantBooleanExpression(Compilation* comp, BooleanValue boolean);
+AstRef buildFunctionCallExpression(Compilation* comp, Slice identifier, AstRef expressionList);
+
+// List Builders: the first element may already be a list
+AstChain buildChain(Compilation* comp, AstListKind kind, AstRef first);
+AstChain buildAppend(Compilation* comp, AstListKind kind, AstChain chain, AstRef element);
+
+#endif
@@ -0,0 +1,525 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rascal_cse.h"
+
+// A tree and the copies of it found while its value holds
+typedef struct CseGroup {
+    Expression* tree;           // First copy, in evaluation order
+    unsigned hash;
+    int size;                   // Instructions the tree takes
+    int copies;
+    int live;                   // No variable of the tree (or the holder) assigned since
+    int hasHolder;              // The first copy is what holder was assigned
+    Binding holder;
+    char* holderName;
+    varType holderType;
+    int hoisted;                // The first copy is moved into a temporary
+    int nextInBucket;           // Group with the same hash bucket found before, -1 for none
+} CseGroup;
+
+// Copy of a tree found in a straight-line run
+typedef struct CseCopy {
+    Expression* node;
+    int group;
+} CseCopy;
+
+// Summary of a scanned tree
+typedef struct TreeInfo {
+    unsigned hash;
+    int size;
+    int callFree;
+} TreeInfo;
+
+#define CSE_MAX_TEMPS 64             // Temporaries a run may take
+#define CSE_BUCKETS 256              // Power of two
+
+// Keeps the elimination context
+typedef struct CseContext {
+    Compilation* comp;
+    CseGroup* groups;
+    int groupCount;
+    int groupCapacity;
+    int buckets[CSE_BUCKETS];   // Last group found of each hash bucket, -1 for none
+    CseCopy* copies;
+    int copyCount;
+    int copyCapacity;
+    int effectSeen;             // The current command already did something visible
+
+    // Scope: the main block or a subroutine
+    int level;
+    VarDeclaration** declarations;  // Variables of the scope, temporaries appended
+    int firstTemp;              // Offset of the first temporary slot
+    int tempCount;              // Temporaries declared in the scope
+    int tempsInUse;             // Taken by the current run
+    VarDeclaration* temps[CSE_MAX_TEMPS];
+    Command* hoisted;           // Temporaries assigned ahead of the current command
+    Command* hoistedTail;
+    int eliminated;             // In the scope
+} CseContext;
+
+// Internal Declarations
+static void cseCommandList(Command** list, CseContext* ctx);
+
+static int varListSize(VarDeclaration* list) {
+    int count = 0;
+    for (; list; list = list->next) count++;
+    return count;
+}
+
+static void enterScope(VarDeclaration** declarations, int level, CseContext* ctx) {
+    ctx->level = level;
+    ctx->declarations = declarations;
+    ctx->firstTemp = varListSize(*declarations);
+    ctx->tempCount = 0;
+    ctx->eliminated = 0;
+}
+
+static void leaveScope(const char* name, CseContext* ctx) {
+    if (ctx->eliminated && ctx->comp->log)
+        fprintf(ctx->comp->log, "\nCommon subexpressions eliminated in %s: %d", name, ctx->eliminated);
+}
+
+// Elimination entry point
+int eliminateCommonSubexpressions(Compilation* comp) {
+    CseContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    memset(ctx.buckets, -1, sizeof(ctx.buckets));
+    ctx.comp = comp;
+    Block* b = comp->astRoot->block;
+
+    int total = 0;
+    for (SubRotDeclaration* sd = b->subRotDeclarations; sd; sd = sd->next) {
+        SubRotBlock* sb = sd->type == Proc ? sd->subrotU.procInfo.subRotBlock : sd->subrotU.funcInfo.subRotBlock;
+        if (!sb) continue;
+        enterScope(&sb->varDeclarations, 1, &ctx);
+        cseCommandList(&sb->commands, &ctx);
+        leaveScope(sd->type == Proc ? sd->subrotU.procInfo.identifier : sd->subrotU.funcInfo.identifier, &ctx);
+        total += ctx.eliminated;
+    }
+    enterScope(&b->varDeclarations, 0, &ctx);
+    cseCommandList(&b->commandList, &ctx);
+    leaveScope("the main block", &ctx);
+    total += ctx.eliminated;
+
+    free(ctx.groups);
+    free(ctx.copies);
+    countOptimization(&comp->stats, "cse", total);
+    return total;
+}
+
+// - Trees --------------------------------
+
+static int sameBinding(Binding a, Binding b) {
+    return a.level == b.level && a.offset == b.offset;
+}
+
+static int sameTree(const Expression* a, const Expression* b) {
+    if (a->type != b->type) return 0;
+    switch (a->type) {
+        case Binary:
+            return a->operator == b->operator && sameTree(a->exprU.binExpr.left, b->exprU.binExpr.left) &&
+                   sameTree(a->exprU.binExpr.right, b->exprU.binExpr.right);
+        case Unary:
+            return a->operator == b->operator && sameTree(a->exprU.unyExpr.right, b->exprU.unyExpr.right);
+        case Var:
+            return sameBinding(a->exprU.varExpr.binding, b->exprU.varExpr.binding);
+        case ConstInt:
+            return a->exprU.intExpr.number == b->exprU.intExpr.number;
+        case ConstBool:
+            return a->exprU.boolExpr.boolean == b->exprU.boolExpr.boolean;
+        default:
+            return 0;
+    }
+}
+
+// Whether the tree reads the variable, or any global when global is set
+static int treeReads(const Expression* e, Binding v, int global) {
+    switch (e->type) {
+        case Binary:
+            return treeReads(e->exprU.binExpr.left, v, global) || treeReads(e->exprU.binExpr.right, v, global);
+        case Unary:
+            return treeReads(e->exprU.unyExpr.right, v, global);
+        case Var:
+            return global ? e->exprU.varExpr.binding.level == 0 : sameBinding(e->exprU.varExpr.binding, v);
+        default:
+            return 0;
+    }
+}
+
+// - Groups -------------------------------
+
+// Ends the groups whose value an assignment to v changes
+static void killVariable(Binding v, CseContext* ctx) {
+    for (int g = 0; g < ctx->groupCount; g++) {
+        CseGroup* group = &ctx->groups[g];
+        if (group->live && ((group->hasHolder && sameBinding(group->holder, v)) || treeReads(group->tree, v, 0)))
+            group->live = 0;
+    }
+}
+
+// Ends the groups an impure call may change: any global
+static void killGlobals(CseContext* ctx) {
+    Binding none = {0, 0};
+    for (int g = 0; g < ctx->groupCount; g++) {
+        CseGroup* group = &ctx->groups[g];
+        if (group->live && ((group->hasHolder && group->holder.level == 0) || treeReads(group->tree, none, 1)))
+            group->live = 0;
+    }
+}
+
+static int findGroup(const Expression* e, unsigned hash, CseContext* ctx) {
+    for (int g = ctx->buckets[hash & (CSE_BUCKETS - 1)]; g >= 0; g = ctx->groups[g].nextInBucket)
+        if (ctx->groups[g].live && ctx->groups[g].hash == hash && sameTree(ctx->groups[g].tree, e)) return g;
+    return -1;
+}
+
+static void newGroup(Expression* e, TreeInfo info, CseContext* ctx) {
+    if (ctx->groupCount == ctx->groupCapacity) {
+        ctx->groupCapacity = ctx->groupCapacity ? ctx->groupCapacity * 2 : 32;
+        ctx->groups = (CseGroup*) realloc(ctx->groups, ctx->groupCapacity * sizeof(CseGroup));
+    }
+    CseGroup* group = &ctx->groups[ctx->groupCount++];
+    memset(group, 0, sizeof(*group));
+    group->tree = e;
+    group->hash = info.hash;
+    group->size = info.size;
+    group->copies = 1;
+    group->live = 1;
+    group->nextInBucket = ctx->buckets[info.hash & (CSE_BUCKETS - 1)];
+    ctx->buckets[info.hash & (CSE_BUCKETS - 1)] = ctx->groupCount - 1;
+}
+
+static void addCopy(Expression* e, int g, CseContext* ctx) {
+    if (ctx->copyCount == ctx->copyCapacity) {
+        ctx->copyCapacity = ctx->copyCapacity ? ctx->copyCapacity * 2 : 32;
+        ctx->copies = (CseCopy*) realloc(ctx->copies, ctx->copyCapacity * sizeof(CseCopy));
+    }
+    ctx->copies[ctx->copyCount].node = e;
+    ctx->copies[ctx->copyCount].group = g;
+    ctx->copyCount++;
+    ctx->groups[g].copies++;
+}
+
+// Forgets what was found inside a tree that turned out to be a copy:
+// the whole tree is replaced, its parts with it
+static void dropSince(int copyMark, int groupMark, CseContext* ctx) {
+    while (ctx->copyCount > copyMark) ctx->groups[ctx->copies[--ctx->copyCount].group].copies--;
+    while (ctx->groupCount > groupMark) {
+        CseGroup* group = &ctx->groups[--ctx->groupCount];
+        ctx->buckets[group->hash & (CSE_BUCKETS - 1)] = group->nextInBucket;
+    }
+}
+
+// - Scan ---------------------------------
+
+static void scanArguments(Expression* e, CseContext* ctx);
+
+// Walks a tree in evaluation order, matching its call-free subtrees
+// against the live groups, largest first. A tree first found after
+// something visible happened in the command starts no group: its first
+// copy could not be computed ahead of the command
+static TreeInfo scanExpression(Expression* e, CseContext* ctx) {
+    TreeInfo info = {(unsigned) e->type, 1, 1};
+    int copyMark = ctx->copyCount, groupMark = ctx->groupCount;
+    TreeInfo l, r;
+
+    switch (e->type) {
+        case Binary:
+            l = scanExpression(e->exprU.binExpr.left, ctx);
+            r = scanExpression(e->exprU.binExpr.right, ctx);
+            info.hash = ((info.hash * 31u + e->operator) * 31u + l.hash) * 31u + r.hash;
+            info.size += l.size + r.size;
+            info.callFree = l.callFree && r.callFree;
+            break;
+        case Unary:
+            r = scanExpression(e->exprU.unyExpr.right, ctx);
+            info.hash = (info.hash * 31u + e->operator) * 31u + r.hash;
+            info.size += r.size;
+            info.callFree = r.callFree;
+            break;
+        case Var:
+            info.hash = (info.hash * 31u + e->exprU.varExpr.binding.level) * 31u + e->exprU.varExpr.binding.offset;
+            break;
+        case ConstInt:
+            info.hash = info.hash * 31u + e->exprU.intExpr.number;
+            break;
+        case ConstBool:
+            info.hash = info.hash * 31u + e->exprU.boolExpr.boolean;
+            break;
+        case FuncCall:
+            scanArguments(e->exprU.funCallExpr.expressionList, ctx);
+            if (!e->exprU.funCallExpr.target->pure) {
+                killGlobals(ctx);
+                ctx->effectSeen = 1;
+            }
+            info.callFree = 0;
+            break;
+    }
+
+    if ((e->type == Binary || e->type == Unary) && info.callFree) {
+        int g = findGroup(e, info.hash, ctx);
+        if (g >= 0) {
+            dropSince(copyMark, groupMark, ctx);
+            addCopy(e, g, ctx);
+        } else if (!ctx->effectSeen) {
+            newGroup(e, info, ctx);
+        }
+    }
+    return info;
+}
+
+// Arguments are evaluated last to first (see generateReverseExpressions)
+static void scanArguments(Expression* e, CseContext* ctx) {
+    if (!e) return;
+    scanArguments(e->next, ctx);
+    scanExpression(e, ctx);
+}
+
+static void scanCommand(Command* c, CseContext* ctx) {
+    ctx->effectSeen = 0;
+    switch (c->type) {
+        case Assign: {
+            Expression* e = c->cmdU.assignInfo.expression;
+            int groupMark = ctx->groupCount;
+            scanExpression(e, ctx);
+            killVariable(c->cmdU.assignInfo.binding, ctx);
+
+            // A whole right side just found keeps its value in the variable
+            if (ctx->groupCount > groupMark) {
+                CseGroup* group = &ctx->groups[ctx->groupCount - 1];
+                if (group->tree == e && group->live) {
+                    group->hasHolder = 1;
+                    group->holder = c->cmdU.assignInfo.binding;
+                    group->holderName = c->cmdU.assignInfo.identifier;
+                    group->holderType = expressionType(e);
+                }
+            }
+            break;
+        }
+        case ProcCall:
+            scanArguments(c->cmdU.procCallInfo.expressionList, ctx);
+            if (!c->cmdU.procCallInfo.target->pure) killGlobals(ctx);
+            break;
+        case Conditional:
+            scanExpression(c->cmdU.condInfo.condExpression, ctx);
+            break;
+        case Read:
+            for (IdentifierList* id = c->cmdU.readInfo.identifiers; id; id = id->next) killVariable(id->binding, ctx);
+            break;
+        case Write:
+            for (Expression* e = c->cmdU.writeInfo.expressionList; e; e = e->next) {
+                scanExpression(e, ctx);
+                ctx->effectSeen = 1;
+            }
+            break;
+        case Loop:
+            break;
+    }
+}
+
+// - Rewrite ------------------------------
+
+// Whether a group pays off: reading the holder takes one instruction,
+// while a temporary also takes a store and a load after its first copy
+static int worthEliminating(const CseGroup* group) {
+    if (group->copies < 2) return 0;
+    if (group->hasHolder) return 1;
+    return (group->copies - 1) * group->size > group->copies + 2;
+}
+
+static int compareCopies(const void* a, const void* b) {
+    const Expression* x = ((const CseCopy*) a)->node;
+    const Expression* y = ((const CseCopy*) b)->node;
+    return (x > y) - (x < y);
+}
+
+// Group of a node when its copies are eliminated, -1 otherwise
+static int groupOf(const Expression* e, CseContext* ctx) {
+    CseCopy key = {(Expression*) e, 0};
+    CseCopy* copy = (CseCopy*) bsearch(&key, ctx->copies, ctx->copyCount, sizeof(CseCopy), compareCopies);
+    return copy ? copy->group : -1;
+}
+
+static Expression* newTempRead(CseGroup* group, CseContext* ctx) {
+    Expression* v = newVariableExpression(&ctx->comp->astArena, group->holderName);
+    v->exprU.varExpr.binding = group->holder;
+    v->exprU.varExpr.valueType = group->holderType;
+    return v;
+}
+
+// Gives a group without a holder a temporary slot of the scope
+static void takeTemp(CseGroup* group, CseContext* ctx) {
+    int index = ctx->tempsInUse++;
+    if (index == ctx->tempCount) {
+        char name[16];
+        int length = snprintf(name, sizeof(name), "$t%d", index);
+        VarDeclaration* vd = newVarDeclaration(&ctx->comp->astArena, expressionType(group->tree),
+                                               internIdentifier(&ctx->comp->identifiers, name, length));
+        VarDeclaration** tail = ctx->declarations;
+        while (*tail) tail = &(*tail)->next;
+        *tail = vd;
+        ctx->temps[ctx->tempCount++] = vd;
+    }
+    group->hasHolder = 1;
+    group->holder.level = ctx->level;
+    group->holder.offset = ctx->firstTemp + index;
+    group->holderName = ctx->temps[index]->identifier;
+    group->holderType = expressionType(group->tree);
+}
+
+static void rewriteExpressionList(Expression** slot, CseContext* ctx);
+
+// Children first, so a first copy moved ahead of the command already
+// reads the temporaries of the copies inside it
+static void rewriteExpression(Expression** slot, CseContext* ctx) {
+    Expression* e = *slot;
+    switch (e->type) {
+        case Binary:
+            rewriteExpression(&e->exprU.binExpr.left, ctx);
+            rewriteExpression(&e->exprU.binExpr.right, ctx);
+            break;
+        case Unary:
+            rewriteExpression(&e->exprU.unyExpr.right, ctx);
+            break;
+        case FuncCall:
+            rewriteExpressionList(&e->exprU.funCallExpr.expressionList, ctx);
+            return;
+        default:
+            return;
+    }
+
+    int g = groupOf(e, ctx);
+    if (g < 0) return;
+    CseGroup* group = &ctx->groups[g];
+
+    if (e == group->tree) {
+        if (group->hoisted == 0) return;        // Stays as the right side of its holder
+        Command* assign = newAssignCommand(&ctx->comp->astArena, group->holderName, e);
+        assign->cmdU.assignInfo.binding = group->holder;
+        if (ctx->hoistedTail) ctx->hoistedTail->next = assign;
+        else ctx->hoisted = assign;
+        ctx->hoistedTail = assign;
+    } else {
+        ctx->eliminated++;
+    }
+
+    Expression* v = newTempRead(group, ctx);
+    v->next = e->next;
+    if (e == group->tree) e->next = NULL;
+    *slot = v;
+}
+
+static void rewriteExpressionList(Expression** slot, CseContext* ctx) {
+    for (; *slot; slot = &(*slot)->next)
+        rewriteExpression(slot, ctx);
+}
+
+static void rewriteCommand(Command* c, CseContext* ctx) {
+    switch (c->type) {
+        case Assign:
+            rewriteExpression(&c->cmdU.assignInfo.expression, ctx);
+            break;
+        case ProcCall:
+            rewriteExpressionList(&c->cmdU.procCallInfo.expressionList, ctx);
+            break;
+        case Conditional:
+            rewriteExpression(&c->cmdU.condInfo.condExpression, ctx);
+            break;
+        case Write:
+            rewriteExpressionList(&c->cmdU.writeInfo.expressionList, ctx);
+            break;
+        default:
+            break;
+    }
+}
+
+// Eliminates the groups of the run from *first up to end (excluded)
+// worth it, computing first copies into temporaries ahead of their command
+static void finishRun(Command** first, Command* end, CseContext* ctx) {
+    int applied = 0;
+    ctx->tempsInUse = 0;
+    for (int g = 0; g < ctx->groupCount; g++) {
+        CseGroup* group = &ctx->groups[g];
+        group->hoisted = 0;
+        if (!worthEliminating(group)) {
+            group->copies = 0;
+            continue;
+        }
+        if (!group->hasHolder) {
+            if (ctx->tempsInUse == CSE_MAX_TEMPS) {
+                group->copies = 0;
+                continue;
+            }
+            takeTemp(group, ctx);
+            group->hoisted = 1;
+        }
+        applied++;
+    }
+
+    if (applied) {
+        // Only copies of eliminated groups, and the first copies moved
+        // into a temporary, are looked up
+        int kept = 0;
+        for (int i = 0; i < ctx->copyCount; i++)
+            if (ctx->groups[ctx->copies[i].group].copies) ctx->copies[kept++] = ctx->copies[i];
+        for (int g = 0; g < ctx->groupCount; g++) {
+            if (!ctx->groups[g].hoisted) continue;
+            if (kept == ctx->copyCapacity) {
+                ctx->copyCapacity = ctx->copyCapacity ? ctx->copyCapacity * 2 : 32;
+                ctx->copies = (CseCopy*) realloc(ctx->copies, ctx->copyCapacity * sizeof(CseCopy));
+            }
+            ctx->copies[kept].node = ctx->groups[g].tree;
+            ctx->copies[kept++].group = g;
+        }
+        ctx->copyCount = kept;
+        qsort(ctx->copies, ctx->copyCount, sizeof(CseCopy), compareCopies);
+
+        for (Command** slot = first; *slot != end; slot = &(*slot)->next) {
+            Command* c = *slot;
+            ctx->hoisted = ctx->hoistedTail = NULL;
+            rewriteCommand(c, ctx);
+            if (ctx->hoisted) {
+                *slot = ctx->hoisted;
+                ctx->hoistedTail->next = c;
+                slot = &ctx->hoistedTail->next;
+            }
+        }
+    }
+
+    for (int g = 0; g < ctx->groupCount; g++) ctx->buckets[ctx->groups[g].hash & (CSE_BUCKETS - 1)] = -1;
+    ctx->groupCount = 0;
+    ctx->copyCount = 0;
+}
+
+// - Commands -----------------------------
+
+// Splits a command list into straight-line runs: a conditional ends the
+// run its condition belongs to, and a loop ends the run before it
+static void cseCommandList(Command** list, CseContext* ctx) {
+    Command** first = list;
+    while (*first) {
+        Command** slot = first;
+        while (*slot && (*slot)->type != Conditional && (*slot)->type != Loop) {
+            scanCommand(*slot, ctx);
+            slot = &(*slot)->next;
+        }
+
+        Command* control = *slot;
+        if (control && control->type == Conditional) {
+            scanCommand(control, ctx);
+            finishRun(first, control->next, ctx);
+        } else {
+            finishRun(first, control, ctx);
+        }
+        if (!control) break;
+
+        if (control->type == Conditional) {
+            cseCommandList(&control->cmdU.condInfo.cmdIf, ctx);
+            cseCommandList(&control->cmdU.condInfo.cmdElse, ctx);
+        } else {
+            cseCommandList(&control->cmdU.loopInfo.cmdLoop, ctx);
+        }
+        first = &control->next;
+    }
+}
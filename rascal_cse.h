@@ -0,0 +1,16 @@
+#ifndef RASCAL_CSE_H
+#define RASCAL_CSE_H
+
+#include "compilation.h"
+
+// Local common subexpression elimination over the annotated AST. Within
+// a straight-line run of commands, a call-free expression tree repeated
+// while none of its variables is assigned is computed once: later copies
+// read the variable the first copy was assigned to, or a temporary slot
+// appended to the variables of the subroutine (or program) that the
+// first copy is moved into, when that takes fewer instructions. The
+// eliminations of each subroutine are written to comp->log. Returns the
+// number of eliminated subexpressions
+int eliminateCommonSubexpressions(Compilation* comp);
+
+#endif
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include "rascal_dead.h"
+
+// Keeps the dead code elimination context
+typedef struct DeadContext {
+    SubRotDeclaration** worklist;   // Reached subroutines whose bodies are not scanned yet
+    int pending;
+    int branches;                   // Conditionals replaced by one of their arms
+    int loops;                      // Loops never entered, or never left
+    int subroutines;                // Subroutines never called
+} DeadContext;
+
+// Internal Declarations
+static void pruneCommandList(Command** slot, DeadContext* ctx);
+static void reachCommandList(Command* c, DeadContext* ctx);
+
+static SubRotBlock* subRotBlockOf(SubRotDeclaration* sd) {
+    return sd->type == Proc ? sd->subrotU.procInfo.subRotBlock : sd->subrotU.funcInfo.subRotBlock;
+}
+
+// Dead code elimination entry point
+int removeDeadCode(Compilation* comp) {
+    DeadContext ctx = {NULL, 0, 0, 0, 0};
+    Block* b = comp->astRoot->block;
+
+    int count = 0;
+    for (SubRotDeclaration* sd = b->subRotDeclarations; sd; sd = sd->next) {
+        SubRotBlock* sb = subRotBlockOf(sd);
+        if (sb) pruneCommandList(&sb->commands, &ctx);
+        sd->calls = 0;
+        count++;
+    }
+    pruneCommandList(&b->commandList, &ctx);
+
+    // Call graph: the main block reaches the subroutines it calls, and
+    // each reached subroutine, once scanned, the ones it calls in turn
+    ctx.worklist = malloc(count * sizeof(SubRotDeclaration*));
+    if (ctx.worklist || count == 0) {
+        reachCommandList(b->commandList, &ctx);
+        while (ctx.pending > 0) {
+            SubRotBlock* sb = subRotBlockOf(ctx.worklist[--ctx.pending]);
+            if (sb) reachCommandList(sb->commands, &ctx);
+        }
+        free(ctx.worklist);
+
+        for (SubRotDeclaration** sd = &b->subRotDeclarations; *sd; ) {
+            if ((*sd)->calls == 0) {
+                *sd = (*sd)->next;
+                ctx.subroutines++;
+            } else {
+                sd = &(*sd)->next;
+            }
+        }
+    }
+
+    countOptimization(&comp->stats, "dead.branch", ctx.branches);
+    countOptimization(&comp->stats, "dead.loop", ctx.loops);
+    countOptimization(&comp->stats, "dead.subroutine", ctx.subroutines);
+    return ctx.branches + ctx.loops + ctx.subroutines;
+}
+
+// - Branches and loops -------------------
+
+// Constant condition: 1 when true, 0 when false, -1 when not constant
+static int constantCondition(const Expression* e) {
+    if (e->type != ConstBool) return -1;
+    return e->exprU.boolExpr.boolean == BoolTrue;
+}
+
+// Puts a command list in the place of the command in *slot, linking its
+// last command to the commands that followed
+static void spliceCommands(Command** slot, Command* list) {
+    Command* rest = (*slot)->next;
+    if (!list) {
+        *slot = rest;
+        return;
+    }
+    *slot = list;
+    while (list->next) list = list->next;
+    list->next = rest;
+}
+
+static void pruneCommandList(Command** slot, DeadContext* ctx) {
+    while (*slot) {
+        Command* c = *slot;
+        int value;
+        switch (c->type) {
+            case Conditional:
+                if ((value = constantCondition(c->cmdU.condInfo.condExpression)) >= 0) {
+                    // The kept arm is pruned when the loop reaches it
+                    spliceCommands(slot, value ? c->cmdU.condInfo.cmdIf : c->cmdU.condInfo.cmdElse);
+                    ctx->branches++;
+                    continue;
+                }
+                pruneCommandList(&c->cmdU.condInfo.cmdIf, ctx);
+                pruneCommandList(&c->cmdU.condInfo.cmdElse, ctx);
+                break;
+            case Loop:
+                value = constantCondition(c->cmdU.loopInfo.loopExpression);
+                if (value == 0) {
+                    spliceCommands(slot, NULL);
+                    ctx->loops++;
+                    continue;
+                }
+                pruneCommandList(&c->cmdU.loopInfo.cmdLoop, ctx);
+                if (value == 1 && c->next) {
+                    // Rascal has no way out of a loop: what follows never runs
+                    c->next = NULL;
+                    ctx->loops++;
+                }
+                break;
+            default:
+                break;
+        }
+        slot = &c->next;
+    }
+}
+
+// - Call graph ---------------------------
+
+static void reachSubroutine(SubRotDeclaration* sd, DeadContext* ctx) {
+    if (sd->calls++ == 0) ctx->worklist[ctx->pending++] = sd;
+}
+
+static void reachExpression(Expression* e, DeadContext* ctx) {
+    for (; e; e = e->next) {
+        switch (e->type) {
+            case Binary:
+                reachExpression(e->exprU.binExpr.left, ctx);
+                reachExpression(e->exprU.binExpr.right, ctx);
+                break;
+            case Unary:
+                reachExpression(e->exprU.unyExpr.right, ctx);
+                break;
+            case FuncCall:
+                reachSubroutine(e->exprU.funCallExpr.target, ctx);
+                reachExpression(e->exprU.funCallExpr.expressionList, ctx);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void reachCommandList(Command* c, DeadContext* ctx) {
+    for (; c; c = c->next) {
+        switch (c->type) {
+            case Assign:
+                reachExpression(c->cmdU.assignInfo.expression, ctx);
+                break;
+            case ProcCall:
+                reachSubroutine(c->cmdU.procCallInfo.target, ctx);
+                reachExpression(c->cmdU.procCallInfo.expressionList, ctx);
+                break;
+            case Conditional:
+                reachExpression(c->cmdU.condInfo.condExpression, ctx);
+                reachCommandList(c->cmdU.condInfo.cmdIf, ctx);
+                reachCommandList(c->cmdU.condInfo.cmdElse, ctx);
+                break;
+            case Loop:
+                reachExpression(c->cmdU.loopInfo.loopExpression, ctx);
+                reachCommandList(c->cmdU.loopInfo.cmdLoop, ctx);
+                break;
+            case Read:
+                break;
+            case Write:
+                reachExpression(c->cmdU.writeInfo.expressionList, ctx);
+                break;
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef RASCAL_DEAD_H
+#define RASCAL_DEAD_H
+
+#include "compilation.h"
+
+// Dead code elimination over the annotated AST. Branches and loops whose
+// condition is a constant (as left by foldConstants) are pruned, commands
+// following a while true loop are dropped, and subroutines not reachable
+// from the main block through the call graph are unlinked from the
+// program, so the code generator never emits them. Returns the number of
+// removals
+int removeDeadCode(Compilation* comp);
+
+#endif
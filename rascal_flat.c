@@ -0,0 +1,357 @@
+#include <stdlib.h>
+#include <string.h>
+#include "rascal_flat.h"
+
+#define INITIAL_ROWS 1024
+
+// Bytes of one row of each table
+#define EXPRESSION_ROW (2 * sizeof(uint8_t) + 3 * sizeof(FlatIndex))
+#define COMMAND_ROW (2 * sizeof(uint8_t) + 4 * sizeof(FlatIndex))
+
+// - Storage ------------------------------
+
+// Grows a column to capacity rows of size bytes
+static void* growColumn(void* column, uint32_t capacity, size_t size) {
+    void* grown = realloc(column, (size_t) capacity * size);
+    if (!grown) {
+        fprintf(stderr, "\nOut of memory.\n");
+        exit(1);
+    }
+    return grown;
+}
+
+// Next capacity of a table, which starts with row 0 taken
+static uint32_t nextCapacity(uint32_t capacity) {
+    return capacity ? capacity * 2 : INITIAL_ROWS;
+}
+
+static void growExpressions(FlatExpressions* t) {
+    t->capacity = nextCapacity(t->capacity);
+    t->kind = (uint8_t*) growColumn(t->kind, t->capacity, sizeof(uint8_t));
+    t->op = (uint8_t*) growColumn(t->op, t->capacity, sizeof(uint8_t));
+    t->lhs = (FlatIndex*) growColumn(t->lhs, t->capacity, sizeof(FlatIndex));
+    t->rhs = (FlatIndex*) growColumn(t->rhs, t->capacity, sizeof(FlatIndex));
+    t->next = (FlatIndex*) growColumn(t->next, t->capacity, sizeof(FlatIndex));
+}
+
+static void growCommands(FlatCommands* t) {
+    t->capacity = nextCapacity(t->capacity);
+    t->kind = (uint8_t*) growColumn(t->kind, t->capacity, sizeof(uint8_t));
+    t->level = (uint8_t*) growColumn(t->level, t->capacity, sizeof(uint8_t));
+    t->a = (FlatIndex*) growColumn(t->a, t->capacity, sizeof(FlatIndex));
+    t->b = (FlatIndex*) growColumn(t->b, t->capacity, sizeof(FlatIndex));
+    t->c = (FlatIndex*) growColumn(t->c, t->capacity, sizeof(FlatIndex));
+    t->next = (FlatIndex*) growColumn(t->next, t->capacity, sizeof(FlatIndex));
+}
+
+// Starts an empty flat AST
+void initFlatAst(FlatAst* ast) {
+    memset(ast, 0, sizeof(*ast));
+    clearFlatAst(ast);
+}
+
+// Forgets every row, keeping the tables for reuse
+void clearFlatAst(FlatAst* ast) {
+    ast->expressions.count = 1;
+    ast->commands.count = 1;
+    ast->variableCount = 1;
+    ast->subroutineCount = 1;
+    ast->complete = 0;
+    ast->name = 0;
+    ast->globals = 0;
+    ast->subroutineList = 0;
+    ast->commandList = 0;
+}
+
+// Releases every table
+void freeFlatAst(FlatAst* ast) {
+    FlatExpressions* e = &ast->expressions;
+    free(e->kind); free(e->op); free(e->lhs); free(e->rhs); free(e->next);
+    FlatCommands* c = &ast->commands;
+    free(c->kind); free(c->level); free(c->a); free(c->b); free(c->c); free(c->next);
+    free(ast->variables);
+    free(ast->subroutines);
+    initFlatAst(ast);
+}
+
+// Bytes taken by the rows in use
+size_t flatAstBytes(const FlatAst* ast) {
+    return ast->expressions.count * EXPRESSION_ROW + ast->commands.count * COMMAND_ROW +
+           ast->variableCount * sizeof(FlatVariable) + ast->subroutineCount * sizeof(FlatSubroutine);
+}
+
+// Prints the rows and the memory holding them
+void printFlatAstStats(const FlatAst* ast, FILE* out) {
+    fprintf(out, "Flat AST: %u expressions, %u commands, %u variables, %u subroutines, %zu bytes used\n",
+        ast->expressions.count - 1, ast->commands.count - 1, ast->variableCount - 1,
+        ast->subroutineCount - 1, flatAstBytes(ast));
+}
+
+// - Row Constructors ---------------------
+
+// Variable Row Constructor (the type is set by the declaration)
+FlatIndex newFlatVariable(FlatAst* ast, uint32_t name) {
+    if (ast->variableCount >= ast->variableCapacity) {
+        ast->variableCapacity = nextCapacity(ast->variableCapacity);
+        ast->variables = (FlatVariable*) growColumn(ast->variables, ast->variableCapacity, sizeof(FlatVariable));
+    }
+    FlatIndex row = ast->variableCount++;
+    ast->variables[row].name = name;
+    ast->variables[row].type = Int;
+    ast->variables[row].next = 0;
+    return row;
+}
+
+// Subroutine Row Constructor: the body comes first, the declaration
+// fills in the rest
+FlatIndex newFlatSubroutine(FlatAst* ast, FlatIndex locals, FlatIndex commands) {
+    if (ast->subroutineCount >= ast->subroutineCapacity) {
+        ast->subroutineCapacity = nextCapacity(ast->subroutineCapacity);
+        ast->subroutines = (FlatSubroutine*) growColumn(ast->subroutines, ast->subroutineCapacity, sizeof(FlatSubroutine));
+    }
+    FlatIndex row = ast->subroutineCount++;
+    FlatSubroutine* s = &ast->subroutines[row];
+    memset(s, 0, sizeof(*s));
+    s->locals = locals;
+    s->commands = commands;
+    return row;
+}
+
+// Command Row Constructor
+FlatIndex newFlatCommand(FlatAst* ast, cmdType kind, FlatIndex a, FlatIndex b, FlatIndex c) {
+    FlatCommands* t = &ast->commands;
+    if (t->count >= t->capacity) growCommands(t);
+    FlatIndex row = t->count++;
+    t->kind[row] = (uint8_t) kind;
+    t->level[row] = 0;
+    t->a[row] = a;
+    t->b[row] = b;
+    t->c[row] = c;
+    t->next[row] = 0;
+    return row;
+}
+
+// Expression Row Constructor
+FlatIndex newFlatExpression(FlatAst* ast, exprType kind, Operator op, FlatIndex lhs, FlatIndex rhs) {
+    FlatExpressions* t = &ast->expressions;
+    if (t->count >= t->capacity) growExpressions(t);
+    FlatIndex row = t->count++;
+    t->kind[row] = (uint8_t) kind;
+    t->op[row] = (uint8_t) op;
+    t->lhs[row] = lhs;
+    t->rhs[row] = rhs;
+    t->next[row] = 0;
+    return row;
+}
+
+// - Print --------------------------------
+
+// Printing context: names come from the intern table
+typedef struct FlatPrinter {
+    const FlatAst* ast;
+    char* const* names;
+    FILE* out;
+} FlatPrinter;
+
+static void printIndent(const FlatPrinter* p, int level) {
+    for (int i = 0; i < level; i++) fprintf(p->out, "|  ");
+}
+
+static void printFlatVariables(const FlatPrinter* p, FlatIndex v, int level) {
+    for (; v; v = p->ast->variables[v].next) {
+        printIndent(p, level);
+        fprintf(p->out, "[VarDecl] Type: %s, ID: %s\n",
+            (p->ast->variables[v].type == Int ? "Integer" : "Boolean"), p->names[p->ast->variables[v].name]);
+    }
+}
+
+static const char* binaryOperatorText(Operator op) {
+    switch (op) {
+        case Equal:          return "=";
+        case Different:      return "<>";
+        case Less:           return "<";
+        case LessEqual:      return "<=";
+        case Greater:        return ">";
+        case GreaterEqual:   return ">=";
+        case Plus:           return "+";
+        case Minus:          return "-";
+        case Or:             return "OR";
+        case Multiplication: return "*";
+        case Division:       return "DIV";
+        case And:            return "AND";
+        default:             return "INVALID (NOT)";
+    }
+}
+
+static void printFlatExpressions(const FlatPrinter* p, FlatIndex e, int level) {
+    const FlatExpressions* t = &p->ast->expressions;
+    for (; e; e = t->next[e]) {
+        printIndent(p, level);
+        switch ((exprType) t->kind[e]) {
+            case Binary:
+                fprintf(p->out, "[Binary Expr]\n");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Op: %s\n", binaryOperatorText((Operator) t->op[e]));
+                printIndent(p, level + 1);
+                fprintf(p->out, "Left:\n");
+                printFlatExpressions(p, t->lhs[e], level + 2);
+                printIndent(p, level + 1);
+                fprintf(p->out, "Right:\n");
+                printFlatExpressions(p, t->rhs[e], level + 2);
+                break;
+
+            case Unary:
+                fprintf(p->out, "[Unary Expr]\n");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Op: %s\n", t->op[e] == Minus ? "-" : t->op[e] == Plus ? "+" : t->op[e] == Not ? "NOT" : "?");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Operand:\n");
+                printFlatExpressions(p, t->rhs[e], level + 2);
+                break;
+
+            case Var:
+                fprintf(p->out, "[Var Expr] ID: %s\n", p->names[t->lhs[e]]);
+                break;
+
+            case ConstInt:
+                fprintf(p->out, "[ConstInt Expr] Value: %d\n", (int) t->lhs[e]);
+                break;
+
+            case ConstBool:
+                fprintf(p->out, "[ConstBool Expr] Value: %s\n", t->lhs[e] == BoolTrue ? "true" : "false");
+                break;
+
+            case FuncCall:
+                fprintf(p->out, "[FuncCall Expr] ID: %s\n", p->names[t->rhs[e]]);
+                printIndent(p, level + 1);
+                fprintf(p->out, "Args:\n");
+                printFlatExpressions(p, t->lhs[e], level + 2);
+                break;
+        }
+    }
+}
+
+static void printFlatCommands(const FlatPrinter* p, FlatIndex c, int level) {
+    const FlatCommands* t = &p->ast->commands;
+    for (; c; c = t->next[c]) {
+        printIndent(p, level);
+        switch ((cmdType) t->kind[c]) {
+            case Assign:
+                fprintf(p->out, "[Assign Cmd]\n");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Target ID: %s\n", p->names[t->a[c]]);
+                printIndent(p, level + 1);
+                fprintf(p->out, "Expr:\n");
+                printFlatExpressions(p, t->b[c], level + 2);
+                break;
+
+            case ProcCall:
+                fprintf(p->out, "[ProcCall Cmd]\n");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Proc ID: %s\n", p->names[t->a[c]]);
+                printIndent(p, level + 1);
+                fprintf(p->out, "Args:\n");
+                printFlatExpressions(p, t->b[c], level + 2);
+                break;
+
+            case Conditional:
+                fprintf(p->out, "[If Cmd]\n");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Condition:\n");
+                printFlatExpressions(p, t->a[c], level + 2);
+                printIndent(p, level + 1);
+                fprintf(p->out, "Then Branch:\n");
+                printFlatCommands(p, t->b[c], level + 2);
+                if (t->c[c]) {
+                    printIndent(p, level + 1);
+                    fprintf(p->out, "Else Branch:\n");
+                    printFlatCommands(p, t->c[c], level + 2);
+                }
+                break;
+
+            case Loop:
+                fprintf(p->out, "[While Cmd]\n");
+                printIndent(p, level + 1);
+                fprintf(p->out, "Condition:\n");
+                printFlatExpressions(p, t->a[c], level + 2);
+                printIndent(p, level + 1);
+                fprintf(p->out, "Body:\n");
+                printFlatCommands(p, t->b[c], level + 2);
+                break;
+
+            case Read:
+                fprintf(p->out, "[Read Cmd] Targets: [");
+                for (FlatIndex id = t->a[c]; id; id = p->ast->expressions.next[id])
+                    fprintf(p->out, "%s%s", id == t->a[c] ? "" : ", ", p->names[p->ast->expressions.lhs[id]]);
+                fprintf(p->out, "]\n");
+                break;
+
+            case Write:
+                fprintf(p->out, "[Write Cmd] Exprs:\n");
+                printFlatExpressions(p, t->a[c], level + 1);
+                break;
+        }
+    }
+}
+
+static void printFlatSubroutines(const FlatPrinter* p, FlatIndex s, int level) {
+    for (; s; s = p->ast->subroutines[s].next) {
+        const FlatSubroutine* sub = &p->ast->subroutines[s];
+        printIndent(p, level);
+        if (sub->kind == Proc)
+            fprintf(p->out, "[Procedure Decl] ID: %s\n", p->names[sub->name]);
+        else
+            fprintf(p->out, "[Function Decl] ID: %s, Return: %s\n", p->names[sub->name], sub->returnType == Int ? "Int" : "Bool");
+
+        printIndent(p, level + 1);
+        fprintf(p->out, "Parameters:\n");
+        printFlatVariables(p, sub->params, level + 2);
+
+        printIndent(p, level + 1);
+        fprintf(p->out, "Body:\n");
+        printIndent(p, level + 2);
+        fprintf(p->out, "[SubRoutine Block]\n");
+        if (sub->locals) {
+            printIndent(p, level + 3);
+            fprintf(p->out, "Local Vars:\n");
+            printFlatVariables(p, sub->locals, level + 4);
+        }
+        printIndent(p, level + 3);
+        fprintf(p->out, "Cmd List:\n");
+        printFlatCommands(p, sub->commands, level + 4);
+    }
+}
+
+// Flat Abstract Syntax Tree Print Function
+void printFlatAst(const FlatAst* ast, const InternTable* identifiers, FILE* out) {
+    if (!ast->complete) return;
+    FlatPrinter p = {ast, identifiers->names, out};
+
+    fprintf(out, "[Program Node]\n");
+    printIndent(&p, 1);
+    fprintf(out, "Identifier: %s\n", p.names[ast->name]);
+    printIndent(&p, 1);
+    fprintf(out, "Block:\n");
+    printIndent(&p, 2);
+    fprintf(out, "[Block Node]\n");
+
+    printIndent(&p, 3);
+    if (ast->globals) {
+        fprintf(out, "Var Decls:\n");
+        printFlatVariables(&p, ast->globals, 4);
+    } else {
+        fprintf(out, "Var Decls: (empty)\n");
+    }
+
+    if (ast->subroutineList) {
+        printIndent(&p, 3);
+        fprintf(out, "SubRots:\n");
+        printFlatSubroutines(&p, ast->subroutineList, 4);
+    }
+
+    if (ast->commandList) {
+        printIndent(&p, 3);
+        fprintf(out, "Commands:\n");
+        printFlatCommands(&p, ast->commandList, 4);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef RASCAL_FLAT_H
+#define RASCAL_FLAT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "rascal_ast.h"
+#include "intern_table.h"
+
+// Flat Abstract Syntax Tree: the layout rascalc --flat-ast builds
+// instead of linked nodes. Expressions and commands are rows of two
+// tables stored column by column (struct of arrays), linked by 32-bit
+// row numbers; row 0 of every table stands for "no node". Identifiers
+// are interned names, by number (see intern_table.h). Only -O0 code is
+// generated from this layout: the AST passes work on linked nodes.
+
+typedef uint32_t FlatIndex;
+
+// Expression Table. What lhs and rhs hold depends on the kind:
+//   Binary      lhs, rhs operands
+//   Unary       rhs operand
+//   Var         lhs name; rhs frame offset and op lexical level, once resolved
+//   ConstInt    lhs value
+//   ConstBool   lhs value
+//   FuncCall    lhs first argument; rhs name, then called subroutine once resolved
+typedef struct FlatExpressions {
+    uint8_t* kind;              // exprType
+    uint8_t* op;                // Operator
+    FlatIndex* lhs;
+    FlatIndex* rhs;
+    FlatIndex* next;            // Next argument or written expression
+    uint32_t count;             // Rows in use, row 0 included
+    uint32_t capacity;
+} FlatExpressions;
+
+// Command Table. What a, b and c hold depends on the kind:
+//   Assign      a target name, b expression; c frame offset and level lexical level, once resolved
+//   ProcCall    a name, then called subroutine once resolved; b first argument
+//   Conditional a condition, b then commands, c else commands
+//   Loop        a condition, b body
+//   Read        a first target (Var expression)
+//   Write       a first expression
+typedef struct FlatCommands {
+    uint8_t* kind;              // cmdType
+    uint8_t* level;
+    FlatIndex* a;
+    FlatIndex* b;
+    FlatIndex* c;
+    FlatIndex* next;            // Next command of the list
+    uint32_t count;
+    uint32_t capacity;
+} FlatCommands;
+
+// Variable or parameter: one row per declared name
+typedef struct FlatVariable {
+    uint32_t name;
+    uint8_t type;               // varType
+    FlatIndex next;
+} FlatVariable;
+
+// Procedure or function
+typedef struct FlatSubroutine {
+    uint32_t name;
+    uint8_t kind;               // subRotType
+    uint8_t returnType;         // varType, functions only
+    FlatIndex params;           // First FlatVariable of each list
+    FlatIndex locals;
+    FlatIndex commands;
+    int label;                  // Entry label, set by the code generator
+    FlatIndex next;
+} FlatSubroutine;
+
+// Flat AST Struct: the tables and the program block
+typedef struct FlatAst {
+    FlatExpressions expressions;
+    FlatCommands commands;
+    FlatVariable* variables;
+    uint32_t variableCount;
+    uint32_t variableCapacity;
+    FlatSubroutine* subroutines;
+    uint32_t subroutineCount;
+    uint32_t subroutineCapacity;
+
+    int complete;               // The parser reduced the whole program
+    uint32_t name;
+    FlatIndex globals;
+    FlatIndex subroutineList;
+    FlatIndex commandList;
+} FlatAst;
+
+// Flat AST functions
+void initFlatAst(FlatAst* ast);
+void clearFlatAst(FlatAst* ast);
+void freeFlatAst(FlatAst* ast);
+size_t flatAstBytes(const FlatAst* ast);
+void printFlatAstStats(const FlatAst* ast, FILE* out);
+
+// Row Constructors: return the new row
+FlatIndex newFlatVariable(FlatAst* ast, uint32_t name);
+FlatIndex newFlatSubroutine(FlatAst* ast, FlatIndex locals, FlatIndex commands);
+FlatIndex newFlatCommand(FlatAst* ast, cmdType kind, FlatIndex a, FlatIndex b, FlatIndex c);
+FlatIndex newFlatExpression(FlatAst* ast, exprType kind, Operator op, FlatIndex lhs, FlatIndex rhs);
+
+// Print Function (same text as printAstRoot)
+void printFlatAst(const FlatAst* ast, const InternTable* identifiers, FILE* out);
+
+#endif
@@ -0,0 +1,244 @@
+#include <limits.h>
+#include "rascal_fold.h"
+
+// Keeps the folding context
+typedef struct FoldContext {
+    Compilation* comp;
+    int constants;              // Subtrees folded into a constant
+    int identities;             // Operations dropped by an identity
+} FoldContext;
+
+// Internal Declarations
+static void foldCommandList(Command* c, FoldContext* ctx);
+static void foldExpressionList(Expression** slot, FoldContext* ctx);
+static void foldExpression(Expression** slot, FoldContext* ctx);
+
+// Folding entry point
+int foldConstants(Compilation* comp) {
+    FoldContext ctx = {comp, 0, 0};
+    Program* p = comp->astRoot;
+
+    for (SubRotDeclaration* sd = p->block->subRotDeclarations; sd; sd = sd->next) {
+        SubRotBlock* sb = sd->type == Proc ? sd->subrotU.procInfo.subRotBlock : sd->subrotU.funcInfo.subRotBlock;
+        if (sb) foldCommandList(sb->commands, &ctx);
+    }
+    foldCommandList(p->block->commandList, &ctx);
+
+    countOptimization(&comp->stats, "fold.constant", ctx.constants);
+    countOptimization(&comp->stats, "fold.identity", ctx.identities);
+    return ctx.constants + ctx.identities;
+}
+
+// - Commands -----------------------------
+
+static void foldCommandList(Command* c, FoldContext* ctx) {
+    for (; c; c = c->next) {
+        switch (c->type) {
+            case Assign:
+                foldExpression(&c->cmdU.assignInfo.expression, ctx);
+                break;
+            case ProcCall:
+                foldExpressionList(&c->cmdU.procCallInfo.expressionList, ctx);
+                break;
+            case Conditional:
+                foldExpression(&c->cmdU.condInfo.condExpression, ctx);
+                foldCommandList(c->cmdU.condInfo.cmdIf, ctx);
+                foldCommandList(c->cmdU.condInfo.cmdElse, ctx);
+                break;
+            case Loop:
+                foldExpression(&c->cmdU.loopInfo.loopExpression, ctx);
+                foldCommandList(c->cmdU.loopInfo.cmdLoop, ctx);
+                break;
+            case Read:
+                break;
+            case Write:
+                foldExpressionList(&c->cmdU.writeInfo.expressionList, ctx);
+                break;
+        }
+    }
+}
+
+// - Helpers ------------------------------
+
+static int isIntConstant(const Expression* e, int value) {
+    return e->type == ConstInt && e->exprU.intExpr.number == value;
+}
+
+static int isBoolConstant(const Expression* e, BooleanValue value) {
+    return e->type == ConstBool && e->exprU.boolExpr.boolean == value;
+}
+
+// Whether dropping the expression keeps the program's behavior: no call
+// (it may write or loop) and no division (it may divide by zero)
+static int isDroppable(const Expression* e) {
+    switch (e->type) {
+        case Binary:
+            return e->operator != Division && isDroppable(e->exprU.binExpr.left) && isDroppable(e->exprU.binExpr.right);
+        case Unary:
+            return isDroppable(e->exprU.unyExpr.right);
+        case FuncCall:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+// Turns a node into a constant in place. Constants hold the smallest
+// union member, so any node has room for one (see rascal_ast.h)
+static void makeIntConstant(Expression* e, int value, FoldContext* ctx) {
+    changeExpressionKind(e, ConstInt);
+    e->exprU.intExpr.number = value;
+    ctx->constants++;
+}
+
+static void makeBoolConstant(Expression* e, int value, FoldContext* ctx) {
+    changeExpressionKind(e, ConstBool);
+    e->exprU.boolExpr.boolean = value ? BoolTrue : BoolFalse;
+    ctx->constants++;
+}
+
+// Puts an operand in the place of its operation
+static void replaceBy(Expression** slot, Expression* operand, FoldContext* ctx) {
+    operand->next = (*slot)->next;
+    *slot = operand;
+    ctx->identities++;
+}
+
+// Integer operation on constants: returns 0 when it cannot be done at
+// compile time (overflow, or division by zero, which is reported)
+static int foldIntOperation(Operator op, int a, int b, int* result, FoldContext* ctx) {
+    long long r;
+    switch (op) {
+        case Plus:           r = (long long) a + b; break;
+        case Minus:          r = (long long) a - b; break;
+        case Multiplication: r = (long long) a * b; break;
+        case Division:
+            if (b == 0) {
+                reportError(ctx->comp, RASCAL_WARNING, 0, "division by zero in a constant expression.");
+                return 0;
+            }
+            r = (long long) a / b;      // Truncates toward zero, as div
+            break;
+        default:
+            return 0;
+    }
+    if (r < INT_MIN || r > INT_MAX) return 0;
+    *result = (int) r;
+    return 1;
+}
+
+static int compareInts(Operator op, int a, int b) {
+    switch (op) {
+        case Equal:        return a == b;
+        case Different:    return a != b;
+        case Less:         return a < b;
+        case LessEqual:    return a <= b;
+        case Greater:      return a > b;
+        case GreaterEqual: return a >= b;
+        default:           return 0;
+    }
+}
+
+// - Expressions --------------------------
+
+static void foldExpressionList(Expression** slot, FoldContext* ctx) {
+    for (; *slot; slot = &(*slot)->next)
+        foldExpression(slot, ctx);
+}
+
+static void foldBinary(Expression** slot, FoldContext* ctx) {
+    Expression* e = *slot;
+    Expression* l = e->exprU.binExpr.left;
+    Expression* r = e->exprU.binExpr.right;
+    Operator op = e->operator;
+    int value;
+
+    // Both operands known
+    if (l->type == ConstInt && r->type == ConstInt) {
+        int a = l->exprU.intExpr.number, b = r->exprU.intExpr.number;
+        if (op == Plus || op == Minus || op == Multiplication || op == Division) {
+            if (foldIntOperation(op, a, b, &value, ctx)) makeIntConstant(e, value, ctx);
+        } else {
+            makeBoolConstant(e, compareInts(op, a, b), ctx);
+        }
+        return;
+    }
+    if (l->type == ConstBool && r->type == ConstBool) {
+        int a = l->exprU.boolExpr.boolean == BoolTrue, b = r->exprU.boolExpr.boolean == BoolTrue;
+        switch (op) {
+            case And:       makeBoolConstant(e, a && b, ctx); break;
+            case Or:        makeBoolConstant(e, a || b, ctx); break;
+            case Equal:     makeBoolConstant(e, a == b, ctx); break;
+            case Different: makeBoolConstant(e, a != b, ctx); break;
+            default: break;
+        }
+        return;
+    }
+
+    // Identities
+    switch (op) {
+        case Plus:
+            if (isIntConstant(r, 0)) replaceBy(slot, l, ctx);
+            else if (isIntConstant(l, 0)) replaceBy(slot, r, ctx);
+            break;
+        case Minus:
+            if (isIntConstant(r, 0)) replaceBy(slot, l, ctx);
+            break;
+        case Multiplication:
+            if (isIntConstant(r, 1)) replaceBy(slot, l, ctx);
+            else if (isIntConstant(l, 1)) replaceBy(slot, r, ctx);
+            else if ((isIntConstant(r, 0) && isDroppable(l)) || (isIntConstant(l, 0) && isDroppable(r))) makeIntConstant(e, 0, ctx);
+            break;
+        case Division:
+            if (isIntConstant(r, 1)) replaceBy(slot, l, ctx);
+            else if (isIntConstant(r, 0)) reportError(ctx->comp, RASCAL_WARNING, 0, "division by zero.");
+            break;
+        case And:
+            if (isBoolConstant(l, BoolTrue)) replaceBy(slot, r, ctx);
+            else if (isBoolConstant(r, BoolTrue)) replaceBy(slot, l, ctx);
+            else if ((isBoolConstant(l, BoolFalse) && isDroppable(r)) || (isBoolConstant(r, BoolFalse) && isDroppable(l))) makeBoolConstant(e, 0, ctx);
+            break;
+        case Or:
+            if (isBoolConstant(l, BoolFalse)) replaceBy(slot, r, ctx);
+            else if (isBoolConstant(r, BoolFalse)) replaceBy(slot, l, ctx);
+            else if ((isBoolConstant(l, BoolTrue) && isDroppable(r)) || (isBoolConstant(r, BoolTrue) && isDroppable(l))) makeBoolConstant(e, 1, ctx);
+            break;
+        default:
+            break;
+    }
+}
+
+static void foldUnary(Expression** slot, FoldContext* ctx) {
+    Expression* e = *slot;
+    Expression* operand = e->exprU.unyExpr.right;
+
+    if (operand->type == ConstInt && e->operator == Minus && operand->exprU.intExpr.number != INT_MIN) {
+        makeIntConstant(e, -operand->exprU.intExpr.number, ctx);
+    } else if (operand->type == ConstBool && e->operator == Not) {
+        makeBoolConstant(e, operand->exprU.boolExpr.boolean != BoolTrue, ctx);
+    } else if (operand->type == Unary && operand->operator == e->operator) {
+        // - - x and not not x
+        replaceBy(slot, operand->exprU.unyExpr.right, ctx);
+    }
+}
+
+// Folds the operands first, so constants propagate up the tree
+static void foldExpression(Expression** slot, FoldContext* ctx) {
+    Expression* e = *slot;
+    switch (e->type) {
+        case Binary:
+            foldExpression(&e->exprU.binExpr.left, ctx);
+            foldExpression(&e->exprU.binExpr.right, ctx);
+            foldBinary(slot, ctx);
+            break;
+        case Unary:
+            foldExpression(&e->exprU.unyExpr.right, ctx);
+            foldUnary(slot, ctx);
+            break;
+        case FuncCall:
+            foldExpressionList(&e->exprU.funCallExpr.expressionList, ctx);
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef RASCAL_FOLD_H
+#define RASCAL_FOLD_H
+
+#include "compilation.h"
+
+// Constant folding and algebraic simplification of the annotated AST:
+// constant subtrees become constants and identities such as x + 0,
+// x * 1 or true and c drop their operation. Division by a constant zero
+// is reported as a warning and left for run time. Returns the number of
+// simplifications
+int foldConstants(Compilation* comp);
+
+#endif
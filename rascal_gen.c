@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// rascalgen: writes a random, semantically valid Rascal program of a
+// given shape, to measure how the compiler scales with input size.
+// The same options and seed always produce the same program.
+
+// Program Shape
+typedef struct GenShape {
+    int globals;                // Global variables
+    int subroutines;            // Procedures and functions, alternating
+    int params;                 // Parameters per subroutine
+    int locals;                 // Local variables per subroutine
+    int statements;             // Statements per body
+    int depth;                  // Expression depth
+    int nesting;                // Nesting of if, while and begin/end
+    unsigned long seed;
+} GenShape;
+
+// Variables visible where code is being generated
+typedef struct GenScope {
+    char** ints;
+    int intCount;
+    char** bools;
+    int boolCount;
+    int intCapacity;
+    int boolCapacity;
+} GenScope;
+
+// Generator Context
+typedef struct GenContext {
+    FILE* out;
+    GenShape shape;
+    unsigned long long state;   // Random number generator
+    int callable;               // Subroutines already written (callable from here)
+    int indent;
+    GenScope scope;
+} GenContext;
+
+// Auxiliar Functions
+static unsigned randomNext(GenContext* ctx) {
+    // xorshift64*
+    ctx->state ^= ctx->state >> 12;
+    ctx->state ^= ctx->state << 25;
+    ctx->state ^= ctx->state >> 27;
+    return (unsigned) ((ctx->state * 2685821657736338717ULL) >> 32);
+}
+
+static int randomBelow(GenContext* ctx, int n) {
+    return n > 0 ? (int) (randomNext(ctx) % (unsigned) n) : 0;
+}
+
+static void writeIndent(GenContext* ctx) {
+    for (int i = 0; i < ctx->indent; i++) fputs("    ", ctx->out);
+}
+
+static void addVariable(GenScope* scope, char* name, int isBool) {
+    char*** list = isBool ? &scope->bools : &scope->ints;
+    int* count = isBool ? &scope->boolCount : &scope->intCount;
+    int* capacity = isBool ? &scope->boolCapacity : &scope->intCapacity;
+
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        *list = (char**) realloc(*list, *capacity * sizeof(char*));
+    }
+    (*list)[(*count)++] = name;
+}
+
+static char* makeName(const char* prefix, int index) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%s%d", prefix, index);
+    return strdup(buffer);
+}
+
+// Subroutine i is a procedure when i is even, a function returning integer otherwise
+static int isFunction(int index) {
+    return index % 2 == 1;
+}
+
+static void subroutineName(char* buffer, size_t size, int index) {
+    snprintf(buffer, size, "%s%d", isFunction(index) ? "fun" : "proc", index);
+}
+
+// Internal declarations
+static void genInt(GenContext* ctx, int depth);
+static void genBool(GenContext* ctx, int depth);
+static void genStatement(GenContext* ctx, int nesting);
+
+// Arguments of a call to subroutine index: parameters alternate integer and boolean
+static void genArguments(GenContext* ctx, int depth) {
+    fputc('(', ctx->out);
+    for (int i = 0; i < ctx->shape.params; i++) {
+        if (i > 0) fputs(", ", ctx->out);
+        if (i % 2 == 0) genInt(ctx, depth);
+        else genBool(ctx, depth);
+    }
+    fputc(')', ctx->out);
+}
+
+// - Expressions --------------------------
+
+static void genInt(GenContext* ctx, int depth) {
+    static const char* operators[] = {"+", "-", "*", "div"};
+    GenScope* s = &ctx->scope;
+
+    int choice = depth > 0 ? randomBelow(ctx, 10) : 0;
+    if (choice < 3) {
+        // Leaf: variable or constant
+        if (s->intCount > 0 && randomBelow(ctx, 3) > 0)
+            fputs(s->ints[randomBelow(ctx, s->intCount)], ctx->out);
+        else
+            fprintf(ctx->out, "%d", randomBelow(ctx, 1000));
+    } else if (choice < 8) {
+        fputc('(', ctx->out);
+        genInt(ctx, depth - 1);
+        fprintf(ctx->out, " %s ", operators[randomBelow(ctx, 4)]);
+        genInt(ctx, depth - 1);
+        fputc(')', ctx->out);
+    } else if (choice < 9 || ctx->callable < 2) {
+        fputs("(-", ctx->out);
+        genInt(ctx, depth - 1);
+        fputc(')', ctx->out);
+    } else {
+        // Call an earlier function (odd index)
+        int index = 2 * randomBelow(ctx, ctx->callable / 2) + 1;
+        char name[32];
+        subroutineName(name, sizeof(name), index);
+        fputs(name, ctx->out);
+        genArguments(ctx, depth - 1);
+    }
+}
+
+static void genBool(GenContext* ctx, int depth) {
+    static const char* relations[] = {"=", "<>", "<", "<=", ">", ">="};
+    GenScope* s = &ctx->scope;
+
+    int choice = depth > 0 ? randomBelow(ctx, 10) : 0;
+    if (choice < 2) {
+        if (s->boolCount > 0 && randomBelow(ctx, 3) > 0)
+            fputs(s->bools[randomBelow(ctx, s->boolCount)], ctx->out);
+        else
+            fputs(randomBelow(ctx, 2) ? "true" : "false", ctx->out);
+    } else if (choice < 6) {
+        fputc('(', ctx->out);
+        genInt(ctx, depth - 1);
+        fprintf(ctx->out, " %s ", relations[randomBelow(ctx, 6)]);
+        genInt(ctx, depth - 1);
+        fputc(')', ctx->out);
+    } else if (choice < 9) {
+        fputc('(', ctx->out);
+        genBool(ctx, depth - 1);
+        fputs(randomBelow(ctx, 2) ? " and " : " or ", ctx->out);
+        genBool(ctx, depth - 1);
+        fputc(')', ctx->out);
+    } else {
+        fputs("not ", ctx->out);
+        genBool(ctx, 0);
+    }
+}
+
+// - Statements ---------------------------
+
+static void genAssign(GenContext* ctx) {
+    GenScope* s = &ctx->scope;
+    int depth = ctx->shape.depth;
+
+    if (s->boolCount > 0 && randomBelow(ctx, 4) == 0) {
+        fprintf(ctx->out, "%s := ", s->bools[randomBelow(ctx, s->boolCount)]);
+        genBool(ctx, depth);
+    } else if (s->intCount > 0) {
+        fprintf(ctx->out, "%s := ", s->ints[randomBelow(ctx, s->intCount)]);
+        genInt(ctx, depth);
+    } else {
+        fputs("write(", ctx->out);
+        genInt(ctx, depth);
+        fputc(')', ctx->out);
+    }
+}
+
+// Statements separated by ';', indented one level. With more set, the
+// last one is also followed by ';' (another statement comes after it)
+static void genStatementList(GenContext* ctx, int count, int nesting, int more) {
+    ctx->indent++;
+    for (int i = 0; i < count; i++) {
+        writeIndent(ctx);
+        genStatement(ctx, nesting);
+        fputs(i + 1 < count || more ? ";\n" : "\n", ctx->out);
+    }
+    ctx->indent--;
+}
+
+static void genStatement(GenContext* ctx, int nesting) {
+    GenScope* s = &ctx->scope;
+    int depth = ctx->shape.depth;
+    int choice = randomBelow(ctx, nesting > 0 ? 12 : 9);
+
+    if (choice < 5) {
+        genAssign(ctx);
+    } else if (choice < 6 && s->intCount > 0) {
+        fprintf(ctx->out, "read(%s)", s->ints[randomBelow(ctx, s->intCount)]);
+    } else if (choice < 7) {
+        fputs("write(", ctx->out);
+        genInt(ctx, depth);
+        fputs(", ", ctx->out);
+        genInt(ctx, depth);
+        fputc(')', ctx->out);
+    } else if (choice < 9) {
+        // Call an earlier procedure (even index)
+        if (ctx->callable < 1) {
+            genAssign(ctx);
+            return;
+        }
+        int index = 2 * randomBelow(ctx, (ctx->callable + 1) / 2);
+        char name[32];
+        subroutineName(name, sizeof(name), index);
+        fputs(name, ctx->out);
+        genArguments(ctx, depth);
+    } else if (choice < 10) {
+        fputs("if ", ctx->out);
+        genBool(ctx, depth);
+        fputs(" then\n", ctx->out);
+        ctx->indent++;
+        writeIndent(ctx);
+        genStatement(ctx, nesting - 1);
+        ctx->indent--;
+        if (randomBelow(ctx, 2)) {
+            fputc('\n', ctx->out);
+            writeIndent(ctx);
+            fputs("else\n", ctx->out);
+            ctx->indent++;
+            writeIndent(ctx);
+            genStatement(ctx, nesting - 1);
+            ctx->indent--;
+        }
+    } else if (choice < 11) {
+        fputs("while ", ctx->out);
+        genBool(ctx, depth);
+        fputs(" do\n", ctx->out);
+        ctx->indent++;
+        writeIndent(ctx);
+        genStatement(ctx, nesting - 1);
+        ctx->indent--;
+    } else {
+        fputs("begin\n", ctx->out);
+        genStatementList(ctx, 1 + randomBelow(ctx, 4), nesting - 1, 0);
+        writeIndent(ctx);
+        fputs("end", ctx->out);
+    }
+}
+
+// - Declarations -------------------------
+
+// Declares names[0..count) one per line, integer or boolean by isBool
+static void genVarDeclarations(GenContext* ctx, const char* prefix, int count) {
+    for (int i = 0; i < count; i++) {
+        char* name = makeName(prefix, i);
+        int isBool = i % 3 == 2;
+        writeIndent(ctx);
+        fprintf(ctx->out, "%s: %s;\n", name, isBool ? "boolean" : "integer");
+        addVariable(&ctx->scope, name, isBool);
+    }
+}
+
+static void genSubroutine(GenContext* ctx, int index) {
+    const GenShape* shape = &ctx->shape;
+    char name[32];
+    subroutineName(name, sizeof(name), index);
+
+    // Globals stay visible: the scope is truncated back to them afterwards
+    int globalInts = ctx->scope.intCount, globalBools = ctx->scope.boolCount;
+
+    writeIndent(ctx);
+    fprintf(ctx->out, "%s %s", isFunction(index) ? "function" : "procedure", name);
+    if (shape->params > 0) {
+        fputc('(', ctx->out);
+        for (int i = 0; i < shape->params; i++) {
+            char* param = makeName("a", i);
+            int isBool = i % 2 == 1;
+            fprintf(ctx->out, "%s%s: %s", i ? "; " : "", param, isBool ? "boolean" : "integer");
+            addVariable(&ctx->scope, param, isBool);
+        }
+        fputc(')', ctx->out);
+    }
+    fputs(isFunction(index) ? ": integer;\n" : ";\n", ctx->out);
+
+    if (shape->locals > 0) {
+        writeIndent(ctx);
+        fputs("var\n", ctx->out);
+        ctx->indent++;
+        genVarDeclarations(ctx, "v", shape->locals);
+        ctx->indent--;
+    }
+
+    writeIndent(ctx);
+    fputs("begin\n", ctx->out);
+    if (isFunction(index)) {
+        // Exactly one return: the last statement
+        genStatementList(ctx, shape->statements, shape->nesting, 1);
+        ctx->indent++;
+        writeIndent(ctx);
+        fprintf(ctx->out, "%s := ", name);
+        genInt(ctx, shape->depth);
+        fputc('\n', ctx->out);
+        ctx->indent--;
+    } else {
+        genStatementList(ctx, shape->statements > 0 ? shape->statements : 1, shape->nesting, 0);
+    }
+    writeIndent(ctx);
+    fputs("end;\n\n", ctx->out);
+
+    for (int i = globalInts; i < ctx->scope.intCount; i++) free(ctx->scope.ints[i]);
+    for (int i = globalBools; i < ctx->scope.boolCount; i++) free(ctx->scope.bools[i]);
+    ctx->scope.intCount = globalInts;
+    ctx->scope.boolCount = globalBools;
+}
+
+static void genProgram(GenContext* ctx) {
+    const GenShape* shape = &ctx->shape;
+
+    fprintf(ctx->out, "program generated;\n\n");
+
+    if (shape->globals > 0) {
+        fputs("var\n", ctx->out);
+        ctx->indent++;
+        genVarDeclarations(ctx, "g", shape->globals);
+        ctx->indent--;
+        fputc('\n', ctx->out);
+    }
+
+    ctx->indent++;
+    for (int i = 0; i < shape->subroutines; i++) {
+        genSubroutine(ctx, i);
+        ctx->callable = i + 1;
+    }
+    ctx->indent--;
+
+    fputs("begin\n", ctx->out);
+    genStatementList(ctx, shape->statements > 0 ? shape->statements : 1, shape->nesting, 0);
+    fputs("end.\n", ctx->out);
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "\nUsage: %s [options] [output_file]\n", program);
+    fprintf(stderr, "  -g <n>  global variables (default 10)\n");
+    fprintf(stderr, "  -p <n>  procedures and functions (default 4)\n");
+    fprintf(stderr, "  -a <n>  parameters per subroutine (default 2)\n");
+    fprintf(stderr, "  -l <n>  local variables per subroutine (default 3)\n");
+    fprintf(stderr, "  -s <n>  statements per body (default 10)\n");
+    fprintf(stderr, "  -d <n>  expression depth (default 3)\n");
+    fprintf(stderr, "  -n <n>  if/while/begin nesting (default 2)\n");
+    fprintf(stderr, "  -r <n>  random seed (default 1)\n");
+}
+
+int main(int argc, char *argv[]) {
+    GenShape shape = {10, 4, 2, 3, 10, 3, 2, 1};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "g:p:a:l:s:d:n:r:h")) != -1) {
+        switch (opt) {
+            case 'g': shape.globals = atoi(optarg); break;
+            case 'p': shape.subroutines = atoi(optarg); break;
+            case 'a': shape.params = atoi(optarg); break;
+            case 'l': shape.locals = atoi(optarg); break;
+            case 's': shape.statements = atoi(optarg); break;
+            case 'd': shape.depth = atoi(optarg); break;
+            case 'n': shape.nesting = atoi(optarg); break;
+            case 'r': shape.seed = strtoul(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    GenContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.shape = shape;
+    ctx.state = shape.seed * 0x9E3779B97F4A7C15ULL + 1;
+    ctx.out = stdout;
+
+    if (optind < argc) {
+        ctx.out = fopen(argv[optind], "w");
+        if (!ctx.out) {
+            fprintf(stderr, "\nError opening output file: %s\n", argv[optind]);
+            return 1;
+        }
+    }
+
+    genProgram(&ctx);
+
+    if (ctx.out != stdout) fclose(ctx.out);
+    for (int i = 0; i < ctx.scope.intCount; i++) free(ctx.scope.ints[i]);
+    for (int i = 0; i < ctx.scope.boolCount; i++) free(ctx.scope.bools[i]);
+    free(ctx.scope.ints);
+    free(ctx.scope.bools);
+
+    return 0;
+}
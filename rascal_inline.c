@@ -0,0 +1,514 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rascal_inline.h"
+#include "semantics.h"
+
+#define INLINE_MAX_ROUNDS 4         // Callers that become small enough are inlined in the next round
+#define INLINE_MAX_SLOTS 256        // Caller slots one inlined body may take
+
+// Calls from one caller to one target inlined
+typedef struct InlineReport {
+    SubRotDeclaration* caller;      // NULL for the main block
+    SubRotDeclaration* target;
+    int count;
+} InlineReport;
+
+// Keeps the inlining context
+typedef struct InlineContext {
+    Compilation* comp;
+    int limit;
+
+    // Caller: the main block or a subroutine
+    SubRotDeclaration* caller;      // NULL for the main block
+    int level;
+    VarDeclaration** declarations;  // Variables of the caller, slots appended
+    int firstSlot;                  // Offset of the first slot
+    int slotCount;                  // Slots declared in the caller
+
+    // Target being inlined
+    SubRotDeclaration* target;
+    int paramCount;
+    int substituting;               // Parameters read their argument instead of a slot
+    int verbatim;                   // Copying an argument, which is caller code
+    Expression* args[INLINE_MAX_SLOTS];
+
+    InlineReport* reports;
+    int reportCount;
+    int reportCapacity;
+    int inlined;
+} InlineContext;
+
+// Internal Declarations
+static void inlineCommandList(Command** slot, InlineContext* ctx);
+
+static char* nameOf(const SubRotDeclaration* sd) {
+    return sd->type == Proc ? sd->subrotU.procInfo.identifier : sd->subrotU.funcInfo.identifier;
+}
+
+static VarDeclaration* paramsOf(const SubRotDeclaration* sd) {
+    return sd->type == Proc ? sd->subrotU.procInfo.formParams : sd->subrotU.funcInfo.formParams;
+}
+
+static SubRotBlock* subRotBlockOf(const SubRotDeclaration* sd) {
+    return sd->type == Proc ? sd->subrotU.procInfo.subRotBlock : sd->subrotU.funcInfo.subRotBlock;
+}
+
+static int varListSize(VarDeclaration* list) {
+    int count = 0;
+    for (; list; list = list->next) count++;
+    return count;
+}
+
+static void enterCaller(SubRotDeclaration* caller, VarDeclaration** declarations, InlineContext* ctx) {
+    ctx->caller = caller;
+    ctx->level = caller ? 1 : 0;
+    ctx->declarations = declarations;
+    ctx->firstSlot = varListSize(*declarations);
+    ctx->slotCount = 0;
+}
+
+static void logReports(InlineContext* ctx) {
+    if (!ctx->comp->log) return;
+    for (int r = 0; r < ctx->reportCount; r++) {
+        InlineReport* report = &ctx->reports[r];
+        fprintf(ctx->comp->log, "\nInlined %d call%s to %s in %s", report->count, report->count > 1 ? "s" : "",
+                nameOf(report->target), report->caller ? nameOf(report->caller) : "the main block");
+    }
+}
+
+static void reportInlined(SubRotDeclaration* target, InlineContext* ctx) {
+    ctx->inlined++;
+    for (int r = 0; r < ctx->reportCount; r++) {
+        if (ctx->reports[r].caller == ctx->caller && ctx->reports[r].target == target) {
+            ctx->reports[r].count++;
+            return;
+        }
+    }
+    if (ctx->reportCount == ctx->reportCapacity) {
+        ctx->reportCapacity = ctx->reportCapacity ? ctx->reportCapacity * 2 : 8;
+        ctx->reports = (InlineReport*) realloc(ctx->reports, ctx->reportCapacity * sizeof(InlineReport));
+    }
+    ctx->reports[ctx->reportCount].caller = ctx->caller;
+    ctx->reports[ctx->reportCount].target = target;
+    ctx->reports[ctx->reportCount].count = 1;
+    ctx->reportCount++;
+}
+
+// Inlining entry point
+int inlineSubroutines(Compilation* comp) {
+    InlineContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.comp = comp;
+    ctx.limit = comp->inlineLimit;
+    Block* b = comp->astRoot->block;
+
+    for (int round = 0; round < INLINE_MAX_ROUNDS && ctx.limit > 0; round++) {
+        int before = ctx.inlined;
+        for (SubRotDeclaration* sd = b->subRotDeclarations; sd; sd = sd->next) {
+            SubRotBlock* sb = subRotBlockOf(sd);
+            if (!sb) continue;
+            enterCaller(sd, &sb->varDeclarations, &ctx);
+            inlineCommandList(&sb->commands, &ctx);
+        }
+        enterCaller(NULL, &b->varDeclarations, &ctx);
+        inlineCommandList(&b->commandList, &ctx);
+        if (ctx.inlined == before) break;
+    }
+
+    logReports(&ctx);
+    free(ctx.reports);
+    countOptimization(&comp->stats, "inline", ctx.inlined);
+    return ctx.inlined;
+}
+
+// - Cost ---------------------------------
+
+// Nodes of an expression or a command list, counted up to limit + 1.
+// calls is set when a call is found
+static int expressionSize(const Expression* e, int limit, int* calls) {
+    int size = 0;
+    for (; e && size <= limit; e = e->next) {
+        size++;
+        switch (e->type) {
+            case Binary:
+                size += expressionSize(e->exprU.binExpr.left, limit, calls);
+                size += expressionSize(e->exprU.binExpr.right, limit, calls);
+                break;
+            case Unary:
+                size += expressionSize(e->exprU.unyExpr.right, limit, calls);
+                break;
+            case FuncCall:
+                *calls = 1;
+                size += expressionSize(e->exprU.funCallExpr.expressionList, limit, calls);
+                break;
+            default:
+                break;
+        }
+    }
+    return size;
+}
+
+static int commandListSize(const Command* c, int limit, int* calls) {
+    int size = 0;
+    for (; c && size <= limit; c = c->next) {
+        size++;
+        switch (c->type) {
+            case Assign:
+                size += expressionSize(c->cmdU.assignInfo.expression, limit, calls);
+                break;
+            case ProcCall:
+                *calls = 1;
+                size += expressionSize(c->cmdU.procCallInfo.expressionList, limit, calls);
+                break;
+            case Conditional:
+                size += expressionSize(c->cmdU.condInfo.condExpression, limit, calls);
+                size += commandListSize(c->cmdU.condInfo.cmdIf, limit, calls);
+                size += commandListSize(c->cmdU.condInfo.cmdElse, limit, calls);
+                break;
+            case Loop:
+                size += expressionSize(c->cmdU.loopInfo.loopExpression, limit, calls);
+                size += commandListSize(c->cmdU.loopInfo.cmdLoop, limit, calls);
+                break;
+            case Read:
+                break;
+            case Write:
+                size += expressionSize(c->cmdU.writeInfo.expressionList, limit, calls);
+                break;
+        }
+    }
+    return size;
+}
+
+// Whether the whole body of the target may replace a call: small, and
+// making no call itself (which also rules recursion out)
+static int inlinesBody(SubRotDeclaration* target, InlineContext* ctx) {
+    if (target == ctx->caller) return 0;
+    SubRotBlock* sb = subRotBlockOf(target);
+    int calls = 0;
+    int size = sb ? commandListSize(sb->commands, ctx->limit, &calls) : 0;
+    int slots = varListSize(paramsOf(target)) + 1 + (sb ? varListSize(sb->varDeclarations) : 0);
+    return size <= ctx->limit && !calls && slots <= INLINE_MAX_SLOTS;
+}
+
+// Expression assigned to the result of a pure function whose body does
+// nothing else, NULL when there is none
+static Expression* resultExpression(SubRotDeclaration* target) {
+    SubRotBlock* sb = subRotBlockOf(target);
+    if (target->type != Func || !target->pure || !sb || !sb->commands || sb->commands->next) return NULL;
+    Command* c = sb->commands;
+    int resultOffset = -5 - varListSize(paramsOf(target));
+    if (c->type != Assign || c->cmdU.assignInfo.binding.level != 1 || c->cmdU.assignInfo.binding.offset != resultOffset) return NULL;
+    return c->cmdU.assignInfo.expression;
+}
+
+// - Slots --------------------------------
+
+// Caller slot of a parameter (offset -5 - i), the result (-5 - n) or a
+// local (0 and up) of the target
+static int slotIndex(int offset, InlineContext* ctx) {
+    return offset >= 0 ? ctx->paramCount + 1 + offset : -5 - offset;
+}
+
+static Binding slotBinding(int index, varType type, InlineContext* ctx) {
+    while (ctx->slotCount <= index) {
+        char name[16];
+        int length = snprintf(name, sizeof(name), "$i%d", ctx->slotCount);
+        VarDeclaration* vd = newVarDeclaration(&ctx->comp->astArena, type, internIdentifier(&ctx->comp->identifiers, name, length));
+        VarDeclaration** tail = ctx->declarations;
+        while (*tail) tail = &(*tail)->next;
+        *tail = vd;
+        ctx->slotCount++;
+    }
+    Binding b = {ctx->level, ctx->firstSlot + index};
+    return b;
+}
+
+// Storage of a target binding once inlined into the caller: globals stay
+static Binding remap(Binding b, varType type, InlineContext* ctx) {
+    if (b.level == 0) return b;
+    return slotBinding(slotIndex(b.offset, ctx), type, ctx);
+}
+
+// - Cloning ------------------------------
+
+static Expression* cloneExpression(const Expression* e, InlineContext* ctx);
+
+static Expression* cloneExpressionList(const Expression* e, InlineContext* ctx) {
+    Expression* head = NULL;
+    Expression** tail = &head;
+    for (; e; e = e->next) {
+        *tail = cloneExpression(e, ctx);
+        tail = &(*tail)->next;
+    }
+    return head;
+}
+
+// Copies an expression of the target. Parameters read the argument
+// itself when substituting, or their caller slot otherwise
+static Expression* cloneExpression(const Expression* e, InlineContext* ctx) {
+    Arena* arena = &ctx->comp->astArena;
+    Expression* copy = NULL;
+    switch (e->type) {
+        case Binary:
+            copy = newBinaryExpression(arena, cloneExpression(e->exprU.binExpr.left, ctx), e->operator,
+                                       cloneExpression(e->exprU.binExpr.right, ctx));
+            break;
+        case Unary:
+            copy = newUnaryExpression(arena, e->operator, cloneExpression(e->exprU.unyExpr.right, ctx));
+            break;
+        case Var: {
+            Binding b = e->exprU.varExpr.binding;
+            if (ctx->verbatim) {
+                copy = newVariableExpression(arena, e->exprU.varExpr.identifier);
+                copy->exprU.varExpr.binding = b;
+            } else if (ctx->substituting && b.level == 1) {
+                ctx->verbatim = 1;
+                copy = cloneExpression(ctx->args[slotIndex(b.offset, ctx)], ctx);
+                ctx->verbatim = 0;
+                return copy;
+            } else {
+                copy = newVariableExpression(arena, e->exprU.varExpr.identifier);
+                copy->exprU.varExpr.binding = remap(b, e->exprU.varExpr.valueType, ctx);
+            }
+            copy->exprU.varExpr.valueType = e->exprU.varExpr.valueType;
+            break;
+        }
+        case ConstInt:
+            copy = newConstantIntegerExpression(arena, e->exprU.intExpr.number);
+            break;
+        case ConstBool:
+            copy = newConstantBooleanExpression(arena, e->exprU.boolExpr.boolean);
+            break;
+        case FuncCall:
+            copy = newFunctionCallExpression(arena, e->exprU.funCallExpr.identifier,
+                                             cloneExpressionList(e->exprU.funCallExpr.expressionList, ctx));
+            copy->exprU.funCallExpr.target = e->exprU.funCallExpr.target;
+            break;
+    }
+    return copy;
+}
+
+static Command* cloneCommandList(const Command* c, InlineContext* ctx) {
+    Arena* arena = &ctx->comp->astArena;
+    Command* head = NULL;
+    Command** tail = &head;
+    for (; c; c = c->next) {
+        Command* copy = NULL;
+        switch (c->type) {
+            case Assign: {
+                Expression* e = c->cmdU.assignInfo.expression;
+                copy = newAssignCommand(arena, c->cmdU.assignInfo.identifier, cloneExpression(e, ctx));
+                copy->cmdU.assignInfo.binding = remap(c->cmdU.assignInfo.binding, expressionType(e), ctx);
+                break;
+            }
+            case ProcCall:
+                copy = newProcCallCommand(arena, c->cmdU.procCallInfo.identifier,
+                                          cloneExpressionList(c->cmdU.procCallInfo.expressionList, ctx));
+                copy->cmdU.procCallInfo.target = c->cmdU.procCallInfo.target;
+                break;
+            case Conditional:
+                copy = newCondCommand(arena, cloneExpression(c->cmdU.condInfo.condExpression, ctx),
+                                      cloneCommandList(c->cmdU.condInfo.cmdIf, ctx), cloneCommandList(c->cmdU.condInfo.cmdElse, ctx));
+                break;
+            case Loop:
+                copy = newLoopCommand(arena, cloneExpression(c->cmdU.loopInfo.loopExpression, ctx),
+                                      cloneCommandList(c->cmdU.loopInfo.cmdLoop, ctx));
+                break;
+            case Read: {
+                IdentifierList* ids = NULL;
+                IdentifierList** idTail = &ids;
+                for (IdentifierList* id = c->cmdU.readInfo.identifiers; id; id = id->next) {
+                    *idTail = newIdentifierList(arena, id->identifier);
+                    (*idTail)->binding = remap(id->binding, Int, ctx);
+                    idTail = &(*idTail)->next;
+                }
+                copy = newReadCommand(arena, ids);
+                break;
+            }
+            case Write:
+                copy = newWriteCommand(arena, cloneExpressionList(c->cmdU.writeInfo.expressionList, ctx));
+                break;
+        }
+        *tail = copy;
+        tail = &copy->next;
+    }
+    return head;
+}
+
+// - Call sites ---------------------------
+
+static void beginTarget(SubRotDeclaration* target, InlineContext* ctx) {
+    ctx->target = target;
+    ctx->paramCount = varListSize(paramsOf(target));
+}
+
+static void substituteCalls(Expression** slot, InlineContext* ctx);
+
+// Replaces the call at *slot by the body of the target, its arguments
+// assigned to the parameter slots first, last to first as a call
+// evaluates them, and rest after it. The arguments stay caller code
+// with calls of their own, which may only be substituted: a body would
+// take the slots assigned so far. Returns the link to rest
+static Command** expandBody(Command** slot, Expression* args, Command* rest, InlineContext* ctx) {
+    Arena* arena = &ctx->comp->astArena;
+    SubRotDeclaration* target = ctx->target;
+    Command* body = cloneCommandList(subRotBlockOf(target)->commands, ctx);
+
+    Command* head = NULL;
+    VarDeclaration* param = paramsOf(target);
+    for (int i = 0; args; i++, param = param->next) {
+        Expression* next = args->next;
+        args->next = NULL;
+        Command* assign = newAssignCommand(arena, param->identifier, args);
+        assign->cmdU.assignInfo.binding = slotBinding(i, param->type, ctx);
+        substituteCalls(&assign->cmdU.assignInfo.expression, ctx);
+        assign->next = head;
+        head = assign;
+        args = next;
+    }
+
+    Command** tail = &head;
+    while (*tail) tail = &(*tail)->next;
+    *tail = body;
+    while (*tail) tail = &(*tail)->next;
+    *tail = rest;
+    *slot = head;
+    reportInlined(target, ctx);
+    return tail;
+}
+
+// - Substitution -------------------------
+
+// Reads of the variable at offset in the target frame
+static int parameterReads(const Expression* e, int offset) {
+    switch (e->type) {
+        case Binary:   return parameterReads(e->exprU.binExpr.left, offset) + parameterReads(e->exprU.binExpr.right, offset);
+        case Unary:    return parameterReads(e->exprU.unyExpr.right, offset);
+        case Var:      return e->exprU.varExpr.binding.level == 1 && e->exprU.varExpr.binding.offset == offset;
+        case FuncCall: {
+            int reads = 0;
+            for (const Expression* a = e->exprU.funCallExpr.expressionList; a; a = a->next) reads += parameterReads(a, offset);
+            return reads;
+        }
+        default:       return 0;
+    }
+}
+
+// Whether the expression reads a local or the result of the target
+static int readsFrame(const Expression* e, int paramCount) {
+    switch (e->type) {
+        case Binary:   return readsFrame(e->exprU.binExpr.left, paramCount) || readsFrame(e->exprU.binExpr.right, paramCount);
+        case Unary:    return readsFrame(e->exprU.unyExpr.right, paramCount);
+        case Var:      return e->exprU.varExpr.binding.level == 1 && -5 - e->exprU.varExpr.binding.offset >= paramCount;
+        case FuncCall:
+            for (const Expression* a = e->exprU.funCallExpr.expressionList; a; a = a->next)
+                if (readsFrame(a, paramCount)) return 1;
+            return 0;
+        default:       return 0;
+    }
+}
+
+// Whether a call to a pure function returning an expression can be
+// replaced by it: the arguments are pure, and the ones read more than
+// once are variables or constants
+static int substitutes(Expression* call, Expression* result, InlineContext* ctx) {
+    int calls = 0;
+    if (expressionSize(result, ctx->limit, &calls) > ctx->limit) return 0;
+    if (readsFrame(result, varListSize(paramsOf(call->exprU.funCallExpr.target)))) return 0;
+    int i = 0;
+    for (Expression* a = call->exprU.funCallExpr.expressionList; a; a = a->next, i++) {
+        if (i == INLINE_MAX_SLOTS || !isPureExpression(a)) return 0;
+        if (a->type != Var && a->type != ConstInt && a->type != ConstBool && parameterReads(result, -5 - i) > 1) return 0;
+    }
+    return 1;
+}
+
+// Replaces the calls of an expression list by the expression their
+// target returns, when substitutes() allows it
+static void substituteCalls(Expression** slot, InlineContext* ctx) {
+    for (; *slot; slot = &(*slot)->next) {
+        Expression* e = *slot;
+        switch (e->type) {
+            case Binary:
+                substituteCalls(&e->exprU.binExpr.left, ctx);
+                substituteCalls(&e->exprU.binExpr.right, ctx);
+                break;
+            case Unary:
+                substituteCalls(&e->exprU.unyExpr.right, ctx);
+                break;
+            case FuncCall: {
+                substituteCalls(&e->exprU.funCallExpr.expressionList, ctx);
+                SubRotDeclaration* target = e->exprU.funCallExpr.target;
+                Expression* result = resultExpression(target);
+                if (!result || target == ctx->caller || !substitutes(e, result, ctx)) break;
+
+                beginTarget(target, ctx);
+                int i = 0;
+                for (Expression* a = e->exprU.funCallExpr.expressionList; a; a = a->next) ctx->args[i++] = a;
+                ctx->substituting = 1;
+                Expression* copy = cloneExpression(result, ctx);
+                ctx->substituting = 0;
+                copy->next = e->next;
+                *slot = copy;
+                reportInlined(target, ctx);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+// - Commands -----------------------------
+
+static void inlineCommandList(Command** slot, InlineContext* ctx) {
+    while (*slot) {
+        Command* c = *slot;
+        switch (c->type) {
+            case Assign: {
+                Expression* e = c->cmdU.assignInfo.expression;
+                SubRotDeclaration* target = e->type == FuncCall ? e->exprU.funCallExpr.target : NULL;
+                Expression* result = target ? resultExpression(target) : NULL;
+                if (target && !(result && substitutes(e, result, ctx)) && inlinesBody(target, ctx)) {
+                    // x := f(args) becomes the body of f, then x := its result slot
+                    beginTarget(target, ctx);
+                    Expression* read = newVariableExpression(&ctx->comp->astArena, nameOf(target));
+                    read->exprU.varExpr.valueType = target->subrotU.funcInfo.returnType;
+                    read->exprU.varExpr.binding = slotBinding(ctx->paramCount, read->exprU.varExpr.valueType, ctx);
+                    c->cmdU.assignInfo.expression = read;
+
+                    slot = &(*expandBody(slot, e->exprU.funCallExpr.expressionList, c, ctx))->next;
+                    continue;
+                }
+                substituteCalls(&c->cmdU.assignInfo.expression, ctx);
+                break;
+            }
+            case ProcCall: {
+                SubRotDeclaration* target = c->cmdU.procCallInfo.target;
+                if (inlinesBody(target, ctx)) {
+                    beginTarget(target, ctx);
+                    slot = expandBody(slot, c->cmdU.procCallInfo.expressionList, c->next, ctx);
+                    continue;
+                }
+                substituteCalls(&c->cmdU.procCallInfo.expressionList, ctx);
+                break;
+            }
+            case Conditional:
+                substituteCalls(&c->cmdU.condInfo.condExpression, ctx);
+                inlineCommandList(&c->cmdU.condInfo.cmdIf, ctx);
+                inlineCommandList(&c->cmdU.condInfo.cmdElse, ctx);
+                break;
+            case Loop:
+                substituteCalls(&c->cmdU.loopInfo.loopExpression, ctx);
+                inlineCommandList(&c->cmdU.loopInfo.cmdLoop, ctx);
+                break;
+            case Read:
+                break;
+            case Write:
+                substituteCalls(&c->cmdU.writeInfo.expressionList, ctx);
+                break;
+        }
+        slot = &c->next;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef RASCAL_INLINE_H
+#define RASCAL_INLINE_H
+
+#include "compilation.h"
+
+#define INLINE_LIMIT_DEFAULT 16     // Body size, in nodes, inlined by default
+
+// Inlining of small subroutines over the annotated AST. A call is
+// replaced by the body of its target when the body takes at most
+// comp->inlineLimit nodes (commands and expression nodes):
+//  - a procedure call, or a function call making up the right side of
+//    an assignment, when the target makes no call itself: arguments are
+//    assigned to fresh slots of the caller frame, which its parameters,
+//    result and locals are remapped to;
+//  - any other function call, even in a loop condition, when the target
+//    is pure and only assigns an expression to its result: the
+//    expression takes its place, reading the (pure) arguments instead
+//    of the parameters.
+// Inlining repeats while callers become small enough, so a recursive
+// subroutine is never inlined. Inlined calls are written to comp->log.
+// Returns the number of inlined call sites
+int inlineSubroutines(Compilation* comp);
+
+#endif
@@ -1,8 +1,10 @@
 #include "rascal_mepa.h"
-#include "symbol_table.h"
+#include "semantics.h"
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 // Auxiliary Write Functions
 static int varListSize(VarDeclaration* list) {
@@ -18,30 +20,152 @@ static int newLabel(CodeGenContext* ctx) {
     return ++(ctx->labelCount);
 }
 
+// Short-circuit lowering of and/or (-O1 and up): the right operand is
+// skipped once the left one decides, which is only allowed when it is
+// pure. In a value context the branches only pay off when they may skip
+// a call
+static int shortCircuits(Expression* e, const CodeGenContext* ctx) {
+    return ctx->shortCircuit && e->type == Binary && (e->operator == And || e->operator == Or) &&
+           isPureExpression(e->exprU.binExpr.right);
+}
+
+static int containsCall(Expression* e) {
+    switch (e->type) {
+        case Binary:   return containsCall(e->exprU.binExpr.left) || containsCall(e->exprU.binExpr.right);
+        case Unary:    return containsCall(e->exprU.unyExpr.right);
+        case FuncCall: return 1;
+        default:       return 0;
+    }
+}
+
+static int branchesForValue(Expression* e, const CodeGenContext* ctx) {
+    return shortCircuits(e, ctx) && containsCall(e->exprU.binExpr.right);
+}
+
+// Labels an expression takes, in a value context or as a condition
+static int countExpressionLabels(Expression* e, const CodeGenContext* ctx);
+
+static int countConditionLabels(Expression* e, const CodeGenContext* ctx) {
+    if (!shortCircuits(e, ctx)) return countExpressionLabels(e, ctx);
+    return (e->operator == Or ? 2 : 0) + countConditionLabels(e->exprU.binExpr.left, ctx) + countConditionLabels(e->exprU.binExpr.right, ctx);
+}
+
+static int isComparison(const Expression* e) {
+    if (e->type != Binary) return 0;
+    switch (e->operator) {
+        case Equal: case Different: case Less: case LessEqual: case Greater: case GreaterEqual:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int countConditionTrueLabels(Expression* e, const CodeGenContext* ctx) {
+    if (shortCircuits(e, ctx)) {
+        if (e->operator == Or) return countConditionTrueLabels(e->exprU.binExpr.left, ctx) + countConditionTrueLabels(e->exprU.binExpr.right, ctx);
+        return 1 + countConditionLabels(e->exprU.binExpr.left, ctx) + countConditionTrueLabels(e->exprU.binExpr.right, ctx);
+    }
+    if (e->type == Unary && e->operator == Not) return countConditionLabels(e->exprU.unyExpr.right, ctx);
+    if (isComparison(e)) return countExpressionLabels(e->exprU.binExpr.left, ctx) + countExpressionLabels(e->exprU.binExpr.right, ctx);
+    return countExpressionLabels(e, ctx);
+}
+
+static int countExpressionListLabels(Expression* e, const CodeGenContext* ctx) {
+    int count = 0;
+    for (; e; e = e->next) count += countExpressionLabels(e, ctx);
+    return count;
+}
+
+static int countExpressionLabels(Expression* e, const CodeGenContext* ctx) {
+    switch (e->type) {
+        case Binary:
+            if (branchesForValue(e, ctx))
+                return 2 + countConditionLabels(e->exprU.binExpr.left, ctx) + countExpressionLabels(e->exprU.binExpr.right, ctx);
+            return countExpressionLabels(e->exprU.binExpr.left, ctx) + countExpressionLabels(e->exprU.binExpr.right, ctx);
+        case Unary:
+            return countExpressionLabels(e->exprU.unyExpr.right, ctx);
+        case FuncCall:
+            return countExpressionListLabels(e->exprU.funCallExpr.expressionList, ctx);
+        default:
+            return 0;
+    }
+}
+
+// Labels a command list takes, so subroutine labels are known before
+// the calls that come ahead of their declaration
+static int countLabels(Command* c, const CodeGenContext* ctx) {
+    int count = 0;
+    for (; c; c = c->next) {
+        switch (c->type) {
+            case Assign:
+                count += countExpressionLabels(c->cmdU.assignInfo.expression, ctx);
+                break;
+            case ProcCall:
+                count += countExpressionListLabels(c->cmdU.procCallInfo.expressionList, ctx);
+                break;
+            case Conditional:
+                count += (c->cmdU.condInfo.cmdElse ? 2 : 1) + countConditionLabels(c->cmdU.condInfo.condExpression, ctx) +
+                         countLabels(c->cmdU.condInfo.cmdIf, ctx) + countLabels(c->cmdU.condInfo.cmdElse, ctx);
+                break;
+            case Loop:
+                count += 2 + countConditionLabels(c->cmdU.loopInfo.loopExpression, ctx) + countLabels(c->cmdU.loopInfo.cmdLoop, ctx);
+                if (ctx->rotateLoops) count += countConditionTrueLabels(c->cmdU.loopInfo.loopExpression, ctx);
+                break;
+            case Read:
+                break;
+            case Write:
+                count += countExpressionListLabels(c->cmdU.writeInfo.expressionList, ctx);
+                break;
+        }
+    }
+    return count;
+}
+
+// Gives each subroutine the label it gets in declaration order, first
+// being the next label to be taken
+static void assignSubroutineLabels(SubRotDeclaration* sd, int first, const CodeGenContext* ctx) {
+    for (; sd; sd = sd->next) {
+        SubRotBlock* sb = (sd->type == Proc ? sd->subrotU.procInfo.subRotBlock : sd->subrotU.funcInfo.subRotBlock);
+        sd->label = first;
+        first += 1 + (sb ? countLabels(sb->commands, ctx) : 0);
+    }
+}
+
 static void writeLabel(CodeGenContext* ctx, int label) {
-    fprintf(ctx->mepaFile, "R%02d: NADA\n", label);
+    appendMepaInstr(ctx->code, OP_NADA, label, 0);
 }
 
-static void writeInstr(CodeGenContext* ctx, const char* op) {
-    fprintf(ctx->mepaFile, "     %s\n", op);
+static void writeInstr(CodeGenContext* ctx, MepaOpcode op) {
+    appendMepaInstr(ctx->code, op, 0, 0);
 }
 
-static void writeInstrIntArg(CodeGenContext* ctx, const char* op, int arg) {
-    fprintf(ctx->mepaFile, "     %s %d\n", op, arg);
+static void writeInstrIntArg(CodeGenContext* ctx, MepaOpcode op, int arg) {
+    appendMepaInstr(ctx->code, op, arg, 0);
 }
 
-static void writeInstr2IntArg(CodeGenContext* ctx, const char* op, int arg1, int arg2) {
-    fprintf(ctx->mepaFile, "     %s %d,%d\n", op, arg1, arg2);
+static void writeInstr2IntArg(CodeGenContext* ctx, MepaOpcode op, int arg1, int arg2) {
+    appendMepaInstr(ctx->code, op, arg1, arg2);
 }
 
-static void writeInstrLabelArg(CodeGenContext* ctx, const char* op, int label) {
-    fprintf(ctx->mepaFile, "     %s R%02d\n", op, label);
+static void writeInstrLabelArg(CodeGenContext* ctx, MepaOpcode op, int label) {
+    appendMepaInstr(ctx->code, op, label, 0);
+}
+
+static void writeCall(CodeGenContext* ctx, SubRotDeclaration* target) {
+    appendMepaInstr(ctx->code, OP_CHPR, target->label, ctx->currentLevel);
+}
+
+// Counts the final instructions for rascalc --stats
+static void countCode(const MepaCode* code, CompileStats* stats) {
+    for (int i = 0; i < code->count; i++) {
+        if (isLabelDefinition(&code->instrs[i])) stats->labels++;
+        countInstruction(stats, code->instrs[i].op);
+    }
 }
 
 // Internal declarations
 static void generateProgram(Program* p, CodeGenContext* ctx);
 static void generateBlock(Block* b, CodeGenContext* ctx);
-static void generateVariableDeclaration(VarDeclaration* vd, CodeGenContext* ctx);
 static void generateSubRotDeclaration(SubRotDeclaration* sd, CodeGenContext* ctx);
 static void generateSubRotBlock(SubRotBlock* sb, CodeGenContext* ctx);
 static void generateCommandList(Command* c, CodeGenContext* ctx);
@@ -51,8 +175,11 @@ static void generateProcedureCallCmd(Command* c, CodeGenContext* ctx);
 static void generateReverseExpressions(Expression* expr, CodeGenContext* ctx);
 static void generateConditionalCmd(Command* c, CodeGenContext* ctx);
 static void generateLoopCmd(Command* c, CodeGenContext* ctx);
+static void generateRotatedLoopCmd(Command* c, CodeGenContext* ctx);
 static void generateReadCmd(Command* c, CodeGenContext* ctx);
 static void generateWriteCmd(Command* c, CodeGenContext* ctx);
+static void generateCondition(Expression* e, int label_false, CodeGenContext* ctx);
+static void generateConditionTrue(Expression* e, int label_true, CodeGenContext* ctx);
 static void generateExpression(Expression* e, CodeGenContext* ctx);
 static void generateBinaryExpr(Expression* e, CodeGenContext* ctx);
 static void generateUnaryExpr(Expression* e, CodeGenContext* ctx);
@@ -60,53 +187,83 @@ static void generateVarExpr(Expression* e, CodeGenContext* ctx);
 static void generateIntExpr(Expression* e, CodeGenContext* ctx);
 static void generateBooleanExpr(Expression* e, CodeGenContext* ctx);
 static void generateFunctionCallExpr(Expression* e, CodeGenContext* ctx);
+static void generateFlatProgram(FlatAst* ast, CodeGenContext* ctx);
 
 // MEPA Code Generation Functions
-void generateCode(Program *root, const char *filename) {
+int generateCodeBuffer(Compilation *comp, MepaBuffer *out) {
+    MepaCode code;
+    initMepaCode(&code);
+
     CodeGenContext ctx;
-    ctx.mepaFile = fopen(filename, "w");
+    ctx.code = &code;
     ctx.labelCount = -1;
     ctx.currentLevel = 0;
+    ctx.shortCircuit = comp->optimize >= 1;
+    ctx.shortCircuits = 0;
+    ctx.rotateLoops = comp->optimize >= 2;
+    ctx.rotatedLoops = 0;
+    ctx.stats = &comp->stats;
+
+    if (comp->flatAst)
+        generateFlatProgram(&comp->flat, &ctx);
+    else
+        generateProgram(comp->astRoot, &ctx);
+    countOptimization(&comp->stats, "short-circuit", ctx.shortCircuits);
+    countOptimization(&comp->stats, "loop-rotation", ctx.rotatedLoops);
+
+    runMepaPasses(&code, comp->optimize, &comp->stats);
+    countCode(&code, &comp->stats);
+
+    int status = writeMepaCode(&code, out);
+    freeMepaCode(&code);
+    return status;
+}
 
-    if (!ctx.mepaFile) {
-        perror("\nError opening mepa object file");
-        return;
+int generateCode(Compilation *comp, const char *filename, MepaFormat format) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        reportError(comp, RASCAL_OUTPUT_ERROR, 0, "Error opening mepa object file: %s", filename);
+        return 1;
     }
 
-    enter_scope(); 
-    generateProgram(root, &ctx);
-    leave_scope();
-
-    fclose(ctx.mepaFile);
-    printf("\nMEPA code generated in: %s", filename);
+    MepaBuffer code;
+    initMepaBuffer(&code, format);
+    int failed = generateCodeBuffer(comp, &code) || writeMepaBuffer(&code, fd);
+    freeMepaBuffer(&code);
+    if (close(fd) != 0) failed = 1;
+    if (failed) {
+        reportError(comp, RASCAL_OUTPUT_ERROR, 0, "Error writing mepa object file: %s", filename);
+        return 1;
+    }
+    if (comp->log) fprintf(comp->log, "\nMEPA code generated in: %s", filename);
+    return 0;
 }
 
 static void generateProgram(Program* p, CodeGenContext* ctx) {
     if (!p) return;
-    writeInstr(ctx, "INPP");
-    install(p->identifier, CAT_PROGRAM, TYPE_VOID, ctx->currentLevel);
+    writeInstr(ctx, OP_INPP);
 
     // Block
     generateBlock(p->block, ctx);
 
-    writeInstr(ctx, "PARA");
-    writeInstr(ctx, "FIM");
+    writeInstr(ctx, OP_PARA);
+    writeInstr(ctx, OP_FIM);
 }
 
 static void generateBlock(Block* b, CodeGenContext* ctx) {
     if (!b) return;
     // Variable Declaration Section
-    generateVariableDeclaration(b->varDeclarations, ctx);
     int global_count = varListSize(b->varDeclarations);
     if (global_count > 0) {
-        writeInstrIntArg(ctx, "AMEM", global_count);
+        writeInstrIntArg(ctx, OP_AMEM, global_count);
     }
 
     // Subroutine Declaration Section
     if (b->subRotDeclarations) {
         int label_main = newLabel(ctx);
-        writeInstrLabelArg(ctx, "DSVS", label_main);
+        writeInstrLabelArg(ctx, OP_DSVS, label_main);
 
+        assignSubroutineLabels(b->subRotDeclarations, label_main + 1, ctx);
         generateSubRotDeclaration(b->subRotDeclarations, ctx);
 
         writeLabel(ctx, label_main);
@@ -117,60 +274,24 @@ static void generateBlock(Block* b, CodeGenContext* ctx) {
     
     // Deallocate Global Variables
     if (global_count > 0) {
-        writeInstrIntArg(ctx, "DMEM", global_count);
-    }
-}
-
-static void generateVariableDeclaration(VarDeclaration *vd, CodeGenContext *ctx) {
-    while (vd) {
-        install(vd->identifier, CAT_VAR, (vd->type == Int ? TYPE_INT : TYPE_BOOL), ctx->currentLevel);
-        vd = vd->next;
+        writeInstrIntArg(ctx, OP_DMEM, global_count);
     }
 }
 
 static void generateSubRotDeclaration(SubRotDeclaration* sd, CodeGenContext* ctx) {
     while (sd) {
-        int label = newLabel(ctx);
-
-        // Install Subroutine in Symbol Table
-        Symbol* s;
-        if (sd->type == Proc) {
-            s = install(sd->subrotU.procInfo.identifier, CAT_PROCEDURE, TYPE_VOID, ctx->currentLevel);
-        } else {
-            s = install(sd->subrotU.funcInfo.identifier, CAT_FUNCTION, (sd->subrotU.funcInfo.returnType == Int ? TYPE_INT : TYPE_BOOL), ctx->currentLevel);
-        }
-        if (s) s->offset = label;
+        // Labels inside the body follow the subroutine label
+        ctx->labelCount = sd->label;
 
         // Enter Subroutine
-        writeLabel(ctx, label);        
+        writeLabel(ctx, sd->label);
         ctx->currentLevel++;
-        enter_scope();
-        writeInstrIntArg(ctx, "ENPR", ctx->currentLevel);
+        writeInstrIntArg(ctx, OP_ENPR, ctx->currentLevel);
 
-        // Verify Parameters Offset
+        // Parameters and the function result were placed by the semantic analysis
         VarDeclaration* params = (sd->type == Proc ? sd->subrotU.procInfo.formParams : sd->subrotU.funcInfo.formParams);
         int n_params = varListSize(params);
 
-        VarDeclaration* p_iter = params;
-        int i = 0;
-        while (p_iter) {
-            int offset = -5 - i;
-            Symbol* param_sym = install(p_iter->identifier, CAT_PARAM, (p_iter->type == Int ? TYPE_INT : TYPE_BOOL), ctx->currentLevel);
-            if(param_sym) param_sym->offset = offset;
-            p_iter = p_iter->next;
-            i++;
-        }
-        
-        // Return, if is function
-        if (sd->type == Func) {
-            int ret_offset = - (5 + n_params);
-            Symbol* ret_symbol = install(sd->subrotU.funcInfo.identifier, CAT_VAR, (sd->subrotU.funcInfo.returnType == Int ? TYPE_INT : TYPE_BOOL), ctx->currentLevel);
-            if (ret_symbol) {
-                ret_symbol->offset = ret_offset;
-                current_scope->next_offset--; 
-            }
-        }
-
         // Create Subroutine Block
         if (sd->type == Proc) {
             generateSubRotBlock(sd->subrotU.procInfo.subRotBlock, ctx);
@@ -179,9 +300,8 @@ static void generateSubRotDeclaration(SubRotDeclaration* sd, CodeGenContext* ctx
         }
 
         // Return from subroutine
-        writeInstrIntArg(ctx, "RTPR", n_params);
+        writeInstrIntArg(ctx, OP_RTPR, n_params);
 
-        leave_scope();
         ctx->currentLevel--;
 
         sd = sd->next;
@@ -191,10 +311,9 @@ static void generateSubRotDeclaration(SubRotDeclaration* sd, CodeGenContext* ctx
 static void generateSubRotBlock(SubRotBlock* sb, CodeGenContext* ctx) {
     if (!sb) return;
     // Allocate Local Variables of Subroutine Block
-    generateVariableDeclaration(sb->varDeclarations, ctx); 
     int local_count = varListSize(sb->varDeclarations);
     if (local_count > 0) {
-        writeInstrIntArg(ctx, "AMEM", local_count);
+        writeInstrIntArg(ctx, OP_AMEM, local_count);
     }
 
     // Commands of Subroutine Block
@@ -202,7 +321,7 @@ static void generateSubRotBlock(SubRotBlock* sb, CodeGenContext* ctx) {
 
     // Deallocate Local Variables
     if (local_count > 0) {
-        writeInstrIntArg(ctx, "DMEM", local_count);
+        writeInstrIntArg(ctx, OP_DMEM, local_count);
     }
 }
 
@@ -227,17 +346,14 @@ static void generateCommand(Command* c, CodeGenContext* ctx) {
 
 static void generateAssignCmd(Command* c, CodeGenContext* ctx) {
     generateExpression(c->cmdU.assignInfo.expression, ctx);
-    Symbol* s = lookup(c->cmdU.assignInfo.identifier);
-    writeInstr2IntArg(ctx, "ARMZ", s->level, s->offset);
+    Binding b = c->cmdU.assignInfo.binding;
+    writeInstr2IntArg(ctx, OP_ARMZ, b.level, b.offset);
 }
 
 static void generateProcedureCallCmd(Command* c, CodeGenContext* ctx) {
-    char* name = c->cmdU.procCallInfo.identifier;
-    Symbol* s = lookup(name);
-
     generateReverseExpressions(c->cmdU.procCallInfo.expressionList, ctx);
 
-    fprintf(ctx->mepaFile, "     CHPR R%02d,%d\n", s->offset, ctx->currentLevel);
+    writeCall(ctx, c->cmdU.procCallInfo.target);
 }
 
 static void generateReverseExpressions(Expression* expr, CodeGenContext* ctx) {
@@ -251,8 +367,7 @@ static void generateConditionalCmd(Command* c, CodeGenContext* ctx) {
         int label_end = newLabel(ctx);
 
         // Conditional Expression
-        generateExpression(c->cmdU.condInfo.condExpression, ctx);
-        writeInstrLabelArg(ctx, "DSVF", label_end);
+        generateCondition(c->cmdU.condInfo.condExpression, label_end, ctx);
 
         // If:
         generateCommandList(c->cmdU.condInfo.cmdIf, ctx);
@@ -264,12 +379,11 @@ static void generateConditionalCmd(Command* c, CodeGenContext* ctx) {
         int label_else = newLabel(ctx);
 
         // Conditional Expression
-        generateExpression(c->cmdU.condInfo.condExpression, ctx);
-        writeInstrLabelArg(ctx, "DSVF", label_else);
+        generateCondition(c->cmdU.condInfo.condExpression, label_else, ctx);
 
         // If:
         generateCommandList(c->cmdU.condInfo.cmdIf, ctx);
-        writeInstrLabelArg(ctx, "DSVS", label_end);
+        writeInstrLabelArg(ctx, OP_DSVS, label_end);
 
         // Else:
         writeLabel(ctx, label_else);
@@ -281,31 +395,54 @@ static void generateConditionalCmd(Command* c, CodeGenContext* ctx) {
 }
 
 static void generateLoopCmd(Command* c, CodeGenContext* ctx) {
+    if (ctx->rotateLoops) {
+        generateRotatedLoopCmd(c, ctx);
+        return;
+    }
+
     int label_loop = newLabel(ctx);
     int label_end = newLabel(ctx);
 
     writeLabel(ctx, label_loop);
 
     // Loop Conditional Expression
-    generateExpression(c->cmdU.loopInfo.loopExpression, ctx);
-    writeInstrLabelArg(ctx, "DSVF", label_end);
+    generateCondition(c->cmdU.loopInfo.loopExpression, label_end, ctx);
 
     // Loop Body
     generateCommandList(c->cmdU.loopInfo.cmdLoop, ctx);
 
     // Loop Check
-    writeInstrLabelArg(ctx, "DSVS", label_loop);
+    writeInstrLabelArg(ctx, OP_DSVS, label_loop);
 
     writeLabel(ctx, label_end);
 }
 
+// Rotated loop (-O2): the condition guards the loop once and is tested
+// again after the body, jumping back while it holds, so an iteration
+// takes one jump instead of two
+static void generateRotatedLoopCmd(Command* c, CodeGenContext* ctx) {
+    int label_body = newLabel(ctx);
+    int label_end = newLabel(ctx);
+
+    // Loop Guard
+    generateCondition(c->cmdU.loopInfo.loopExpression, label_end, ctx);
+
+    // Loop Body
+    writeLabel(ctx, label_body);
+    generateCommandList(c->cmdU.loopInfo.cmdLoop, ctx);
+
+    // Loop Check
+    generateConditionTrue(c->cmdU.loopInfo.loopExpression, label_body, ctx);
+
+    writeLabel(ctx, label_end);
+    ctx->rotatedLoops++;
+}
+
 static void generateReadCmd(Command* c, CodeGenContext* ctx) {
     IdentifierList* id = c->cmdU.readInfo.identifiers;
     while(id) {
-        writeInstr(ctx, "LEIT");
-        
-        Symbol* s = lookup(id->identifier);
-        if (s) writeInstr2IntArg(ctx, "ARMZ", s->level, s->offset);
+        writeInstr(ctx, OP_LEIT);
+        writeInstr2IntArg(ctx, OP_ARMZ, id->binding.level, id->binding.offset);
         id = id->next;
     }
 }
@@ -314,11 +451,86 @@ static void generateWriteCmd(Command* c, CodeGenContext* ctx) {
     Expression* e = c->cmdU.writeInfo.expressionList;
     while (e) {
         generateExpression(e, ctx);
-        writeInstr(ctx, "IMPR");
+        writeInstr(ctx, OP_IMPR);
         e = e->next;
     }
 }
 
+// Jumps to label_false when the condition does not hold, and falls
+// through when it does. Short-circuit and/or become jump chains: MEPA
+// only jumps on false, so or jumps over its right operand once the left
+// one holds
+static void generateCondition(Expression* e, int label_false, CodeGenContext* ctx) {
+    if (!shortCircuits(e, ctx)) {
+        generateExpression(e, ctx);
+        writeInstrLabelArg(ctx, OP_DSVF, label_false);
+        return;
+    }
+
+    ctx->shortCircuits++;
+    if (e->operator == And) {
+        generateCondition(e->exprU.binExpr.left, label_false, ctx);
+        generateCondition(e->exprU.binExpr.right, label_false, ctx);
+    } else {
+        int label_right = newLabel(ctx);
+        int label_true = newLabel(ctx);
+
+        generateCondition(e->exprU.binExpr.left, label_right, ctx);
+        writeInstrLabelArg(ctx, OP_DSVS, label_true);
+
+        writeLabel(ctx, label_right);
+        generateCondition(e->exprU.binExpr.right, label_false, ctx);
+
+        writeLabel(ctx, label_true);
+    }
+}
+
+// Comparison testing the opposite of op
+static MepaOpcode invertedComparison(Operator op) {
+    switch (op) {
+        case Equal:        return OP_CMDG;
+        case Different:    return OP_CMIG;
+        case Less:         return OP_CMAG;
+        case LessEqual:    return OP_CMMA;
+        case Greater:      return OP_CMEG;
+        default:           return OP_CMME;     // GreaterEqual
+    }
+}
+
+// Jumps to label_true when the condition holds, and falls through when
+// it does not. MEPA has no jump on true: comparisons are inverted, not
+// jumps on false of its operand, and anything else is negated
+static void generateConditionTrue(Expression* e, int label_true, CodeGenContext* ctx) {
+    if (shortCircuits(e, ctx)) {
+        ctx->shortCircuits++;
+        if (e->operator == Or) {
+            generateConditionTrue(e->exprU.binExpr.left, label_true, ctx);
+            generateConditionTrue(e->exprU.binExpr.right, label_true, ctx);
+        } else {
+            int label_false = newLabel(ctx);
+            generateCondition(e->exprU.binExpr.left, label_false, ctx);
+            generateConditionTrue(e->exprU.binExpr.right, label_true, ctx);
+            writeLabel(ctx, label_false);
+        }
+        return;
+    }
+
+    if (e->type == Unary && e->operator == Not) {
+        generateCondition(e->exprU.unyExpr.right, label_true, ctx);
+        return;
+    }
+
+    if (isComparison(e)) {
+        generateExpression(e->exprU.binExpr.left, ctx);
+        generateExpression(e->exprU.binExpr.right, ctx);
+        writeInstr(ctx, invertedComparison(e->operator));
+    } else {
+        generateExpression(e, ctx);
+        writeInstr(ctx, OP_NEGA);
+    }
+    writeInstrLabelArg(ctx, OP_DSVF, label_true);
+}
+
 static void generateExpression(Expression* e, CodeGenContext* ctx) {
     if (!e) return;
     switch (e->type) {
@@ -331,56 +543,265 @@ static void generateExpression(Expression* e, CodeGenContext* ctx) {
     }
 }
 
+// Short-circuit and/or in a value context: the left operand decides
+// whether the right one is evaluated or the result is already known
+static void generateBranchingExpr(Expression* e, CodeGenContext* ctx) {
+    int label_other = newLabel(ctx);
+    int label_end = newLabel(ctx);
+
+    ctx->shortCircuits++;
+    generateCondition(e->exprU.binExpr.left, label_other, ctx);
+    if (e->operator == And) {
+        generateExpression(e->exprU.binExpr.right, ctx);
+        writeInstrLabelArg(ctx, OP_DSVS, label_end);
+        writeLabel(ctx, label_other);
+        writeInstrIntArg(ctx, OP_CRCT, 0);
+    } else {
+        writeInstrIntArg(ctx, OP_CRCT, 1);
+        writeInstrLabelArg(ctx, OP_DSVS, label_end);
+        writeLabel(ctx, label_other);
+        generateExpression(e->exprU.binExpr.right, ctx);
+    }
+    writeLabel(ctx, label_end);
+}
+
 static void generateBinaryExpr(Expression* e, CodeGenContext* ctx) {
+    if (branchesForValue(e, ctx)) {
+        generateBranchingExpr(e, ctx);
+        return;
+    }
+
     generateExpression(e->exprU.binExpr.left, ctx);
     generateExpression(e->exprU.binExpr.right, ctx);
     
-    switch (e->exprU.binExpr.operator) {
-        case Plus:           writeInstr(ctx, "SOMA"); break;
-        case Minus:          writeInstr(ctx, "SUBT"); break;
-        case Multiplication: writeInstr(ctx, "MULT"); break;
-        case Division:       writeInstr(ctx, "DIVI"); break;
-        case Equal:          writeInstr(ctx, "CMIG"); break;
-        case Different:      writeInstr(ctx, "CMDG"); break;
-        case Less:           writeInstr(ctx, "CMME"); break;
-        case LessEqual:      writeInstr(ctx, "CMEG"); break;
-        case Greater:        writeInstr(ctx, "CMMA"); break;
-        case GreaterEqual:   writeInstr(ctx, "CMAG"); break;
-        case And:            writeInstr(ctx, "CONJ"); break;
-        case Or:             writeInstr(ctx, "DISJ"); break;
+    switch (e->operator) {
+        case Plus:           writeInstr(ctx, OP_SOMA); break;
+        case Minus:          writeInstr(ctx, OP_SUBT); break;
+        case Multiplication: writeInstr(ctx, OP_MULT); break;
+        case Division:       writeInstr(ctx, OP_DIVI); break;
+        case Equal:          writeInstr(ctx, OP_CMIG); break;
+        case Different:      writeInstr(ctx, OP_CMDG); break;
+        case Less:           writeInstr(ctx, OP_CMME); break;
+        case LessEqual:      writeInstr(ctx, OP_CMEG); break;
+        case Greater:        writeInstr(ctx, OP_CMMA); break;
+        case GreaterEqual:   writeInstr(ctx, OP_CMAG); break;
+        case And:            writeInstr(ctx, OP_CONJ); break;
+        case Or:             writeInstr(ctx, OP_DISJ); break;
         default: break;
     }
 }
 
 static void generateUnaryExpr(Expression* e, CodeGenContext* ctx) {
     generateExpression(e->exprU.unyExpr.right, ctx);
-    switch (e->exprU.unyExpr.operator) {
-        case Minus: writeInstr(ctx, "INVR"); break;
-        case Not:   writeInstr(ctx, "NEGA"); break;
+    switch (e->operator) {
+        case Minus: writeInstr(ctx, OP_INVR); break;
+        case Not:   writeInstr(ctx, OP_NEGA); break;
         default: break;
     }
 }
 
 static void generateVarExpr(Expression* e, CodeGenContext* ctx) {
-    Symbol* s = lookup(e->exprU.varExpr.identifier);
-    writeInstr2IntArg(ctx, "CRVL", s->level, s->offset);
+    Binding b = e->exprU.varExpr.binding;
+    writeInstr2IntArg(ctx, OP_CRVL, b.level, b.offset);
 }
 
 static void generateIntExpr(Expression* e, CodeGenContext* ctx) {
-    writeInstrIntArg(ctx, "CRCT", e->exprU.intExpr.number);
+    writeInstrIntArg(ctx, OP_CRCT, e->exprU.intExpr.number);
 }
 
 static void generateBooleanExpr(Expression* e, CodeGenContext* ctx) {
-    writeInstrIntArg(ctx, "CRCT", (e->exprU.boolExpr.boolean == BoolTrue ? 1 : 0));
+    writeInstrIntArg(ctx, OP_CRCT, (e->exprU.boolExpr.boolean == BoolTrue ? 1 : 0));
 }
 
 static void generateFunctionCallExpr(Expression* e, CodeGenContext* ctx) {
-    char* name = e->exprU.funCallExpr.identifier;
-    Symbol* s = lookup(name);
-
-    writeInstrIntArg(ctx, "AMEM", 1);
+    writeInstrIntArg(ctx, OP_AMEM, 1);
 
     generateReverseExpressions(e->exprU.funCallExpr.expressionList, ctx);
 
-    fprintf(ctx->mepaFile, "     CHPR R%02d,%d\n", s->offset, ctx->currentLevel);
-}
\ No newline at end of file
+    writeCall(ctx, e->exprU.funCallExpr.target);
+}
+// - Flat Layout --------------------------
+
+// The -O0 code of the flat layout, instruction for instruction the code
+// of the linked one. Nothing short-circuits at -O0, so only commands take
+// labels
+
+static int flatVariableCount(const FlatAst* ast, FlatIndex v) {
+    int count = 0;
+    for (; v; v = ast->variables[v].next) count++;
+    return count;
+}
+
+static int countFlatLabels(const FlatAst* ast, FlatIndex c) {
+    const FlatCommands* t = &ast->commands;
+    int count = 0;
+    for (; c; c = t->next[c]) {
+        if (t->kind[c] == Conditional)
+            count += (t->c[c] ? 2 : 1) + countFlatLabels(ast, t->b[c]) + countFlatLabels(ast, t->c[c]);
+        else if (t->kind[c] == Loop)
+            count += 2 + countFlatLabels(ast, t->b[c]);
+    }
+    return count;
+}
+
+static void writeFlatCall(CodeGenContext* ctx, const FlatAst* ast, FlatIndex target) {
+    appendMepaInstr(ctx->code, OP_CHPR, ast->subroutines[target].label, ctx->currentLevel);
+}
+
+static void generateFlatExpression(const FlatAst* ast, FlatIndex e, CodeGenContext* ctx);
+
+static void generateFlatReverseExpressions(const FlatAst* ast, FlatIndex e, CodeGenContext* ctx) {
+    if (!e) return;
+    generateFlatReverseExpressions(ast, ast->expressions.next[e], ctx);
+    generateFlatExpression(ast, e, ctx);
+}
+
+static void generateFlatExpression(const FlatAst* ast, FlatIndex e, CodeGenContext* ctx) {
+    const FlatExpressions* t = &ast->expressions;
+    switch (t->kind[e]) {
+        case Binary:
+            generateFlatExpression(ast, t->lhs[e], ctx);
+            generateFlatExpression(ast, t->rhs[e], ctx);
+            switch (t->op[e]) {
+                case Plus:           writeInstr(ctx, OP_SOMA); break;
+                case Minus:          writeInstr(ctx, OP_SUBT); break;
+                case Multiplication: writeInstr(ctx, OP_MULT); break;
+                case Division:       writeInstr(ctx, OP_DIVI); break;
+                case Equal:          writeInstr(ctx, OP_CMIG); break;
+                case Different:      writeInstr(ctx, OP_CMDG); break;
+                case Less:           writeInstr(ctx, OP_CMME); break;
+                case LessEqual:      writeInstr(ctx, OP_CMEG); break;
+                case Greater:        writeInstr(ctx, OP_CMMA); break;
+                case GreaterEqual:   writeInstr(ctx, OP_CMAG); break;
+                case And:            writeInstr(ctx, OP_CONJ); break;
+                case Or:             writeInstr(ctx, OP_DISJ); break;
+                default: break;
+            }
+            break;
+        case Unary:
+            generateFlatExpression(ast, t->rhs[e], ctx);
+            switch (t->op[e]) {
+                case Minus: writeInstr(ctx, OP_INVR); break;
+                case Not:   writeInstr(ctx, OP_NEGA); break;
+                default: break;
+            }
+            break;
+        case Var:
+            writeInstr2IntArg(ctx, OP_CRVL, t->op[e], (int) t->rhs[e]);
+            break;
+        case ConstInt:
+            writeInstrIntArg(ctx, OP_CRCT, (int) t->lhs[e]);
+            break;
+        case ConstBool:
+            writeInstrIntArg(ctx, OP_CRCT, (t->lhs[e] == BoolTrue ? 1 : 0));
+            break;
+        case FuncCall:
+            writeInstrIntArg(ctx, OP_AMEM, 1);
+            generateFlatReverseExpressions(ast, t->lhs[e], ctx);
+            writeFlatCall(ctx, ast, t->rhs[e]);
+            break;
+    }
+}
+
+static void generateFlatCommands(const FlatAst* ast, FlatIndex c, CodeGenContext* ctx) {
+    const FlatCommands* t = &ast->commands;
+    for (; c; c = t->next[c]) {
+        switch (t->kind[c]) {
+            case Assign:
+                generateFlatExpression(ast, t->b[c], ctx);
+                writeInstr2IntArg(ctx, OP_ARMZ, t->level[c], (int) t->c[c]);
+                break;
+            case ProcCall:
+                generateFlatReverseExpressions(ast, t->b[c], ctx);
+                writeFlatCall(ctx, ast, t->a[c]);
+                break;
+            case Conditional: {
+                int label_end = newLabel(ctx);
+                int label_else = t->c[c] ? newLabel(ctx) : label_end;
+
+                generateFlatExpression(ast, t->a[c], ctx);
+                writeInstrLabelArg(ctx, OP_DSVF, label_else);
+                generateFlatCommands(ast, t->b[c], ctx);
+                if (t->c[c]) {
+                    writeInstrLabelArg(ctx, OP_DSVS, label_end);
+                    writeLabel(ctx, label_else);
+                    generateFlatCommands(ast, t->c[c], ctx);
+                }
+                writeLabel(ctx, label_end);
+                break;
+            }
+            case Loop: {
+                int label_loop = newLabel(ctx);
+                int label_end = newLabel(ctx);
+
+                writeLabel(ctx, label_loop);
+                generateFlatExpression(ast, t->a[c], ctx);
+                writeInstrLabelArg(ctx, OP_DSVF, label_end);
+                generateFlatCommands(ast, t->b[c], ctx);
+                writeInstrLabelArg(ctx, OP_DSVS, label_loop);
+                writeLabel(ctx, label_end);
+                break;
+            }
+            case Read:
+                for (FlatIndex e = t->a[c]; e; e = ast->expressions.next[e]) {
+                    writeInstr(ctx, OP_LEIT);
+                    writeInstr2IntArg(ctx, OP_ARMZ, ast->expressions.op[e], (int) ast->expressions.rhs[e]);
+                }
+                break;
+            case Write:
+                for (FlatIndex e = t->a[c]; e; e = ast->expressions.next[e]) {
+                    generateFlatExpression(ast, e, ctx);
+                    writeInstr(ctx, OP_IMPR);
+                }
+                break;
+        }
+    }
+}
+
+// Subroutines take their labels in declaration order, first being the
+// next label to be taken
+static void generateFlatSubroutines(FlatAst* ast, CodeGenContext* ctx) {
+    int first = ctx->labelCount + 1;
+    for (FlatIndex s = ast->subroutineList; s; s = ast->subroutines[s].next) {
+        ast->subroutines[s].label = first;
+        first += 1 + countFlatLabels(ast, ast->subroutines[s].commands);
+    }
+
+    for (FlatIndex s = ast->subroutineList; s; s = ast->subroutines[s].next) {
+        const FlatSubroutine* sub = &ast->subroutines[s];
+        ctx->labelCount = sub->label;
+
+        writeLabel(ctx, sub->label);
+        ctx->currentLevel++;
+        writeInstrIntArg(ctx, OP_ENPR, ctx->currentLevel);
+
+        int local_count = flatVariableCount(ast, sub->locals);
+        if (local_count > 0) writeInstrIntArg(ctx, OP_AMEM, local_count);
+        generateFlatCommands(ast, sub->commands, ctx);
+        if (local_count > 0) writeInstrIntArg(ctx, OP_DMEM, local_count);
+
+        writeInstrIntArg(ctx, OP_RTPR, flatVariableCount(ast, sub->params));
+        ctx->currentLevel--;
+    }
+}
+
+static void generateFlatProgram(FlatAst* ast, CodeGenContext* ctx) {
+    writeInstr(ctx, OP_INPP);
+
+    int global_count = flatVariableCount(ast, ast->globals);
+    if (global_count > 0) writeInstrIntArg(ctx, OP_AMEM, global_count);
+
+    if (ast->subroutineList) {
+        int label_main = newLabel(ctx);
+        writeInstrLabelArg(ctx, OP_DSVS, label_main);
+        generateFlatSubroutines(ast, ctx);
+        writeLabel(ctx, label_main);
+    }
+
+    generateFlatCommands(ast, ast->commandList, ctx);
+
+    if (global_count > 0) writeInstrIntArg(ctx, OP_DMEM, global_count);
+
+    writeInstr(ctx, OP_PARA);
+    writeInstr(ctx, OP_FIM);
+}
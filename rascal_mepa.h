@@ -1,16 +1,31 @@
 #ifndef RASCAL_MEPA_H
 #define RASCAL_MEPA_H
 
-#include "rascal_ast.h"
+#include "compilation.h"
+#include "mepa_emit.h"
+#include "mepa_ir.h"
+#include "mepa_opt.h"
 
 // Keeps the code generation context
 typedef struct CodeGenContext {
-    FILE *mepaFile;
+    MepaCode *code;             // Instructions, optimized and serialized once complete
     int labelCount;
     int currentLevel;
+    int shortCircuit;           // Lower and/or with pure right operands to jumps
+    int shortCircuits;          // Operations lowered so
+    int rotateLoops;            // Test while conditions after the body
+    int rotatedLoops;
+    CompileStats *stats;
 } CodeGenContext;
 
-// Executes the MEPA code generation
-void generateCode(Program *root, const char *filename);
+// Executes the MEPA code generation appending to a caller's buffer, in
+// its format, or into a file written at once (both return 0 on success).
+// The instructions are first built as a list and run through the
+// optimization passes of comp->optimize.
+// The AST, linked or flat (comp->flatAst, -O0 only), must have passed
+// semanticCheck: code generation walks its annotations, without looking
+// names up
+int generateCodeBuffer(Compilation *comp, MepaBuffer *code);
+int generateCode(Compilation *comp, const char *filename, MepaFormat format);
 
 #endif
\ No newline at end of file
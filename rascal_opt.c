@@ -0,0 +1,22 @@
+#include "rascal_opt.h"
+#include "rascal_inline.h"
+#include "rascal_fold.h"
+#include "rascal_dead.h"
+#include "rascal_cse.h"
+
+// Passes in the order they run
+static const AstPass passes[] = {
+    {"inline", 2, inlineSubroutines}, // First, so fold and dead clean inlined bodies up
+    {"fold", 1, foldConstants},
+    {"dead", 1, removeDeadCode},     // After fold, which leaves constant conditions
+    {"cse", 2, eliminateCommonSubexpressions},
+};
+
+#define PASS_COUNT ((int) (sizeof(passes) / sizeof(passes[0])))
+
+void optimizeProgram(Compilation* comp) {
+    if (!comp->astRoot || !comp->astRoot->block) return;
+
+    for (int p = 0; p < PASS_COUNT; p++)
+        if (passes[p].level <= comp->optimize) passes[p].run(comp);
+}
@@ -0,0 +1,20 @@
+#ifndef RASCAL_OPT_H
+#define RASCAL_OPT_H
+
+#include "compilation.h"
+
+// AST optimization passes, run between semanticCheck and code generation.
+// Each pass declares the lowest -O level that runs it, like the MEPA
+// passes (see mepa_opt.h), and counts what it changed in comp->stats.
+
+// AST Pass Struct
+typedef struct AstPass {
+    const char* name;
+    int level;                  // Lowest -O level running the pass
+    int (*run)(Compilation* comp);
+} AstPass;
+
+// Runs the AST passes of comp->optimize over comp->astRoot
+void optimizeProgram(Compilation* comp);
+
+#endif
@@ -0,0 +1,2218 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "rascal_parser.y"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compilation.h"
+
+#line 78 "rascal_parser.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "rascal_parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_PROGRAM = 3,                    /* PROGRAM  */
+  YYSYMBOL_TBEGIN = 4,                     /* TBEGIN  */
+  YYSYMBOL_END = 5,                        /* END  */
+  YYSYMBOL_PROCEDURE = 6,                  /* PROCEDURE  */
+  YYSYMBOL_FUNCTION = 7,                   /* FUNCTION  */
+  YYSYMBOL_VAR = 8,                        /* VAR  */
+  YYSYMBOL_INTEGER = 9,                    /* INTEGER  */
+  YYSYMBOL_BOOLEAN = 10,                   /* BOOLEAN  */
+  YYSYMBOL_TFALSE = 11,                    /* TFALSE  */
+  YYSYMBOL_TTRUE = 12,                     /* TTRUE  */
+  YYSYMBOL_WHILE = 13,                     /* WHILE  */
+  YYSYMBOL_DO = 14,                        /* DO  */
+  YYSYMBOL_IF = 15,                        /* IF  */
+  YYSYMBOL_THEN = 16,                      /* THEN  */
+  YYSYMBOL_ELSE = 17,                      /* ELSE  */
+  YYSYMBOL_READ = 18,                      /* READ  */
+  YYSYMBOL_WRITE = 19,                     /* WRITE  */
+  YYSYMBOL_AND = 20,                       /* AND  */
+  YYSYMBOL_OR = 21,                        /* OR  */
+  YYSYMBOL_NOT = 22,                       /* NOT  */
+  YYSYMBOL_DIV = 23,                       /* DIV  */
+  YYSYMBOL_DIF = 24,                       /* DIF  */
+  YYSYMBOL_LTE = 25,                       /* LTE  */
+  YYSYMBOL_GTE = 26,                       /* GTE  */
+  YYSYMBOL_ASSIGN = 27,                    /* ASSIGN  */
+  YYSYMBOL_ID = 28,                        /* ID  */
+  YYSYMBOL_NUM = 29,                       /* NUM  */
+  YYSYMBOL_30_ = 30,                       /* '='  */
+  YYSYMBOL_31_ = 31,                       /* '<'  */
+  YYSYMBOL_32_ = 32,                       /* '>'  */
+  YYSYMBOL_33_ = 33,                       /* '+'  */
+  YYSYMBOL_34_ = 34,                       /* '-'  */
+  YYSYMBOL_35_ = 35,                       /* '*'  */
+  YYSYMBOL_LOWER_THAN_ELSE = 36,           /* LOWER_THAN_ELSE  */
+  YYSYMBOL_37_ = 37,                       /* ';'  */
+  YYSYMBOL_38_ = 38,                       /* '.'  */
+  YYSYMBOL_39_ = 39,                       /* ':'  */
+  YYSYMBOL_40_ = 40,                       /* ','  */
+  YYSYMBOL_41_ = 41,                       /* '('  */
+  YYSYMBOL_42_ = 42,                       /* ')'  */
+  YYSYMBOL_YYACCEPT = 43,                  /* $accept  */
+  YYSYMBOL_program = 44,                   /* program  */
+  YYSYMBOL_block = 45,                     /* block  */
+  YYSYMBOL_var_decl_sec_optional = 46,     /* var_decl_sec_optional  */
+  YYSYMBOL_var_decl_sec = 47,              /* var_decl_sec  */
+  YYSYMBOL_var_decl_list = 48,             /* var_decl_list  */
+  YYSYMBOL_var_decl = 49,                  /* var_decl  */
+  YYSYMBOL_id_list = 50,                   /* id_list  */
+  YYSYMBOL_type = 51,                      /* type  */
+  YYSYMBOL_subr_decl_sec_optional = 52,    /* subr_decl_sec_optional  */
+  YYSYMBOL_subr_decl_sec = 53,             /* subr_decl_sec  */
+  YYSYMBOL_subr_decl = 54,                 /* subr_decl  */
+  YYSYMBOL_proc_decl = 55,                 /* proc_decl  */
+  YYSYMBOL_func_decl = 56,                 /* func_decl  */
+  YYSYMBOL_form_param_optional = 57,       /* form_param_optional  */
+  YYSYMBOL_form_param = 58,                /* form_param  */
+  YYSYMBOL_form_param_list = 59,           /* form_param_list  */
+  YYSYMBOL_subr_block = 60,                /* subr_block  */
+  YYSYMBOL_compound_cmd = 61,              /* compound_cmd  */
+  YYSYMBOL_cmd_list = 62,                  /* cmd_list  */
+  YYSYMBOL_cmd = 63,                       /* cmd  */
+  YYSYMBOL_assign_cmd = 64,                /* assign_cmd  */
+  YYSYMBOL_proc_call_cmd = 65,             /* proc_call_cmd  */
+  YYSYMBOL_cond_cmd = 66,                  /* cond_cmd  */
+  YYSYMBOL_else_part_optional = 67,        /* else_part_optional  */
+  YYSYMBOL_loop_cmd = 68,                  /* loop_cmd  */
+  YYSYMBOL_read_cmd = 69,                  /* read_cmd  */
+  YYSYMBOL_write_cmd = 70,                 /* write_cmd  */
+  YYSYMBOL_expr_list_optional = 71,        /* expr_list_optional  */
+  YYSYMBOL_expr_list = 72,                 /* expr_list  */
+  YYSYMBOL_expr = 73,                      /* expr  */
+  YYSYMBOL_relational = 74,                /* relational  */
+  YYSYMBOL_simple_expr = 75,               /* simple_expr  */
+  YYSYMBOL_term = 76,                      /* term  */
+  YYSYMBOL_factor = 77,                    /* factor  */
+  YYSYMBOL_variable = 78,                  /* variable  */
+  YYSYMBOL_logical = 79,                   /* logical  */
+  YYSYMBOL_func_call = 80                  /* func_call  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 19 "rascal_parser.y"
+
+    int yylex(YYSTYPE* yylval_param, yyscan_t scanner);
+    void yyerror(Compilation* comp, yyscan_t scanner, const char *s);
+    int yyget_lineno(yyscan_t scanner);
+
+#line 199 "rascal_parser.tab.c"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  4
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   111
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  43
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  38
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  77
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  138
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   285
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+      41,    42,    35,    33,    40,    34,    38,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    39,    37,
+      31,    30,    32,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    36
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   102,   102,   110,   117,   118,   122,   126,   127,   131,
+     145,   146,   150,   151,   155,   156,   160,   161,   165,   166,
+     170,   174,   178,   179,   183,   187,   188,   192,   196,   200,
+     201,   205,   206,   207,   208,   209,   210,   211,   215,   219,
+     223,   227,   228,   232,   236,   240,   244,   245,   249,   250,
+     254,   255,   259,   260,   261,   262,   263,   264,   268,   269,
+     270,   271,   272,   273,   277,   278,   279,   280,   284,   285,
+     286,   287,   288,   289,   293,   297,   298,   302
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "PROGRAM", "TBEGIN",
+  "END", "PROCEDURE", "FUNCTION", "VAR", "INTEGER", "BOOLEAN", "TFALSE",
+  "TTRUE", "WHILE", "DO", "IF", "THEN", "ELSE", "READ", "WRITE", "AND",
+  "OR", "NOT", "DIV", "DIF", "LTE", "GTE", "ASSIGN", "ID", "NUM", "'='",
+  "'<'", "'>'", "'+'", "'-'", "'*'", "LOWER_THAN_ELSE", "';'", "'.'",
+  "':'", "','", "'('", "')'", "$accept", "program", "block",
+  "var_decl_sec_optional", "var_decl_sec", "var_decl_list", "var_decl",
+  "id_list", "type", "subr_decl_sec_optional", "subr_decl_sec",
+  "subr_decl", "proc_decl", "func_decl", "form_param_optional",
+  "form_param", "form_param_list", "subr_block", "compound_cmd",
+  "cmd_list", "cmd", "assign_cmd", "proc_call_cmd", "cond_cmd",
+  "else_part_optional", "loop_cmd", "read_cmd", "write_cmd",
+  "expr_list_optional", "expr_list", "expr", "relational", "simple_expr",
+  "term", "factor", "variable", "logical", "func_call", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-78)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int8 yypact[] =
+{
+      15,    -8,    25,   -10,   -78,    37,     5,    12,    54,   -78,
+     -78,     5,    19,    23,   -78,    41,    44,    61,    54,    42,
+     -78,   -78,    48,   -78,    68,    58,    46,    46,    40,   -78,
+      52,   -78,   -78,   -78,   -78,   -78,   -78,     5,    53,   -78,
+      55,     2,     2,    51,    56,   -18,   -78,     3,   -78,   -78,
+     -78,   -78,   -78,   -78,   -78,   -78,   -78,   -26,    37,    68,
+     -78,   -78,    10,    57,   -78,    10,    10,     2,    77,    50,
+      29,   -78,   -78,   -78,   -78,    79,     5,     2,     2,     2,
+     -78,    40,     5,   -78,    61,   -78,    59,   -78,     2,    29,
+      29,    60,    40,    10,   -78,   -78,   -78,   -78,   -78,   -78,
+      10,    10,     2,    10,    10,    10,    40,   -30,   -23,   -78,
+     -78,    62,    63,   -78,   -78,   -78,    37,    64,   -78,   -78,
+      29,    29,    29,    33,   -78,   -78,   -78,    76,   -78,     2,
+     -78,   -78,   -78,   -78,    40,   -78,   -78,   -78
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,     0,     0,     0,     1,     5,     0,     0,    15,     4,
+      10,     6,     0,     0,     2,     0,     0,     0,    14,     0,
+      18,    19,     0,     7,     0,     0,    23,    23,     0,     3,
+       0,    16,     8,    12,    13,     9,    11,     0,     0,    22,
+       0,     0,     0,     0,     0,     0,    37,     0,    29,    31,
+      32,    33,    34,    35,    36,    17,    25,     0,     5,     0,
+      76,    75,     0,    74,    69,     0,     0,     0,     0,    50,
+      58,    64,    68,    70,    71,     0,     0,     0,     0,    47,
+      28,     0,     0,    24,     0,    20,     0,    73,    47,    59,
+      60,     0,     0,     0,    53,    55,    57,    52,    54,    56,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    48,
+      38,     0,    46,    30,    26,    27,     5,     0,    72,    43,
+      63,    61,    62,    51,    67,    66,    65,    42,    44,     0,
+      45,    39,    21,    77,     0,    40,    49,    41
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -78,   -78,   -78,    94,   -78,   -78,    -9,    24,    49,   -78,
+     -78,    83,   -78,   -78,    78,   -78,   -78,    -7,   -14,   -78,
+     -77,   -78,   -78,   -78,   -78,   -78,   -78,   -78,    22,    30,
+     -41,   -78,     9,   -59,   -57,   -78,   -78,   -78
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,     2,     7,    84,     9,    11,    12,    13,    35,    17,
+      18,    19,    20,    21,    38,    39,    57,    85,    46,    47,
+      48,    49,    50,    51,   135,    52,    53,    54,   111,   112,
+     109,   102,    69,    70,    71,    72,    73,    74
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_uint8 yytable[] =
+{
+      68,    75,    22,    29,   113,    87,    89,    90,    80,    78,
+      25,    82,   128,    60,    61,   119,    83,   129,     1,   130,
+       3,    60,    61,    79,    62,     4,    91,     5,    56,   127,
+      63,    64,    62,    10,   120,    65,    66,   110,    63,    64,
+      81,   121,   122,    67,    28,     6,   124,   125,   126,   103,
+      14,    67,   104,    41,    93,    42,    23,   137,    43,    44,
+      15,    16,    24,    25,   105,    28,   100,   101,    45,    26,
+     115,    93,    27,   114,    94,    95,    96,    33,    34,    31,
+      97,    98,    99,   100,   101,    32,    36,    37,   136,    55,
+      58,    92,    76,   134,    59,   106,   116,    77,    88,     8,
+     107,    30,   118,   129,   131,    40,   133,   108,    86,   132,
+     117,   123
+};
+
+static const yytype_uint8 yycheck[] =
+{
+      41,    42,    11,    17,    81,    62,    65,    66,     5,    27,
+      40,    37,    42,    11,    12,    92,    42,    40,     3,    42,
+      28,    11,    12,    41,    22,     0,    67,    37,    37,   106,
+      28,    29,    22,    28,    93,    33,    34,    78,    28,    29,
+      37,   100,   101,    41,     4,     8,   103,   104,   105,    20,
+      38,    41,    23,    13,    21,    15,    37,   134,    18,    19,
+       6,     7,    39,    40,    35,     4,    33,    34,    28,    28,
+      84,    21,    28,    82,    24,    25,    26,     9,    10,    37,
+      30,    31,    32,    33,    34,    37,    28,    41,   129,    37,
+      37,    14,    41,    17,    39,    16,    37,    41,    41,     5,
+      76,    18,    42,    40,    42,    27,    42,    77,    59,   116,
+      88,   102
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,    44,    28,     0,    37,     8,    45,    46,    47,
+      28,    48,    49,    50,    38,     6,     7,    52,    53,    54,
+      55,    56,    49,    37,    39,    40,    28,    28,     4,    61,
+      54,    37,    37,     9,    10,    51,    28,    41,    57,    58,
+      57,    13,    15,    18,    19,    28,    61,    62,    63,    64,
+      65,    66,    68,    69,    70,    37,    49,    59,    37,    39,
+      11,    12,    22,    28,    29,    33,    34,    41,    73,    75,
+      76,    77,    78,    79,    80,    73,    41,    41,    27,    41,
+       5,    37,    37,    42,    46,    60,    51,    77,    41,    76,
+      76,    73,    14,    21,    24,    25,    26,    30,    31,    32,
+      33,    34,    74,    20,    23,    35,    16,    50,    72,    73,
+      73,    71,    72,    63,    49,    61,    37,    71,    42,    63,
+      76,    76,    76,    75,    77,    77,    77,    63,    42,    40,
+      42,    42,    60,    42,    17,    67,    73,    63
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    43,    44,    45,    46,    46,    47,    48,    48,    49,
+      50,    50,    51,    51,    52,    52,    53,    53,    54,    54,
+      55,    56,    57,    57,    58,    59,    59,    60,    61,    62,
+      62,    63,    63,    63,    63,    63,    63,    63,    64,    65,
+      66,    67,    67,    68,    69,    70,    71,    71,    72,    72,
+      73,    73,    74,    74,    74,    74,    74,    74,    75,    75,
+      75,    75,    75,    75,    76,    76,    76,    76,    77,    77,
+      77,    77,    77,    77,    78,    79,    79,    80
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     5,     3,     1,     0,     2,     2,     3,     3,
+       1,     3,     1,     1,     1,     0,     2,     3,     1,     1,
+       5,     7,     1,     0,     3,     1,     3,     2,     3,     1,
+       3,     1,     1,     1,     1,     1,     1,     1,     3,     4,
+       5,     2,     0,     4,     4,     4,     1,     0,     1,     3,
+       1,     3,     1,     1,     1,     1,     1,     1,     1,     2,
+       2,     3,     3,     3,     1,     3,     3,     3,     1,     1,
+       1,     1,     3,     2,     1,     1,     1,     4
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (comp, scanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, comp, scanner); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, Compilation* comp, yyscan_t scanner)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (comp);
+  YY_USE (scanner);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, Compilation* comp, yyscan_t scanner)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, comp, scanner);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, Compilation* comp, yyscan_t scanner)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], comp, scanner);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, comp, scanner); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
+/* Return the length of YYSTR.  */
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
+{
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
+}
+# endif
+#endif
+
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
+/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
+   YYDEST.  */
+static char *
+yystpcpy (char *yydest, const char *yysrc)
+{
+  char *yyd = yydest;
+  const char *yys = yysrc;
+
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
+
+  return yyd - 1;
+}
+# endif
+#endif
+
+#ifndef yytnamerr
+/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
+   quotes and backslashes, so that it's suitable for yyerror.  The
+   heuristic is that double-quoting is unnecessary unless the string
+   contains an apostrophe, a comma, or backslash (other than
+   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
+   null, do not copy; instead, return the length of what the result
+   would have been.  */
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
+{
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
+
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
+
+
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
+}
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, Compilation* comp, yyscan_t scanner)
+{
+  YY_USE (yyvaluep);
+  YY_USE (comp);
+  YY_USE (scanner);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (Compilation* comp, yyscan_t scanner)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* program: PROGRAM ID ';' block '.'  */
+#line 103 "rascal_parser.y"
+    { 
+        (yyval.prog) = newProgram(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[-3].slice)), (yyvsp[-1].block));
+        comp->astRoot = (yyval.prog);
+    }
+#line 1525 "rascal_parser.tab.c"
+    break;
+
+  case 3: /* block: var_decl_sec_optional subr_decl_sec_optional compound_cmd  */
+#line 111 "rascal_parser.y"
+    {
+        (yyval.block) = newBlock(&comp->astArena, (yyvsp[-2].varDecl), (yyvsp[-1].subRotDecl), (yyvsp[0].cmd));
+    }
+#line 1533 "rascal_parser.tab.c"
+    break;
+
+  case 4: /* var_decl_sec_optional: var_decl_sec  */
+#line 117 "rascal_parser.y"
+                                    {(yyval.varDecl) = (yyvsp[0].varDecl);}
+#line 1539 "rascal_parser.tab.c"
+    break;
+
+  case 5: /* var_decl_sec_optional: %empty  */
+#line 118 "rascal_parser.y"
+                                    {(yyval.varDecl) = NULL;}
+#line 1545 "rascal_parser.tab.c"
+    break;
+
+  case 6: /* var_decl_sec: VAR var_decl_list  */
+#line 122 "rascal_parser.y"
+                                    {(yyval.varDecl) = (yyvsp[0].varDeclChain).head;}
+#line 1551 "rascal_parser.tab.c"
+    break;
+
+  case 7: /* var_decl_list: var_decl ';'  */
+#line 126 "rascal_parser.y"
+                                    {(yyval.varDeclChain) = newVarDeclarationChain((yyvsp[-1].varDecl));}
+#line 1557 "rascal_parser.tab.c"
+    break;
+
+  case 8: /* var_decl_list: var_decl_list var_decl ';'  */
+#line 127 "rascal_parser.y"
+                                    {(yyval.varDeclChain) = addVarDeclaration((yyvsp[-2].varDeclChain), (yyvsp[-1].varDecl));}
+#line 1563 "rascal_parser.tab.c"
+    break;
+
+  case 9: /* var_decl: id_list ':' type  */
+#line 132 "rascal_parser.y"
+    {
+        IdentifierList* it = (yyvsp[-2].idChain).head;
+        VarDeclarationChain list = newVarDeclarationChain(NULL);
+        while (it) {
+            VarDeclaration* node = newVarDeclaration(&comp->astArena, (yyvsp[0].vType), it->identifier);
+            list = addVarDeclaration(list, node);
+            it = it->next;
+        }
+        (yyval.varDecl) = list.head;
+    }
+#line 1578 "rascal_parser.tab.c"
+    break;
+
+  case 10: /* id_list: ID  */
+#line 145 "rascal_parser.y"
+                                    {(yyval.idChain) = newIdentifierChain(newIdentifierList(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[0].slice))));}
+#line 1584 "rascal_parser.tab.c"
+    break;
+
+  case 11: /* id_list: id_list ',' ID  */
+#line 146 "rascal_parser.y"
+                                    {(yyval.idChain) = addIdentifier((yyvsp[-2].idChain), newIdentifierList(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[0].slice))));}
+#line 1590 "rascal_parser.tab.c"
+    break;
+
+  case 12: /* type: INTEGER  */
+#line 150 "rascal_parser.y"
+                                    {(yyval.vType) = Int;}
+#line 1596 "rascal_parser.tab.c"
+    break;
+
+  case 13: /* type: BOOLEAN  */
+#line 151 "rascal_parser.y"
+                                    {(yyval.vType) = Bool;}
+#line 1602 "rascal_parser.tab.c"
+    break;
+
+  case 14: /* subr_decl_sec_optional: subr_decl_sec  */
+#line 155 "rascal_parser.y"
+                                    {(yyval.subRotDecl) = (yyvsp[0].subRotDeclChain).head;}
+#line 1608 "rascal_parser.tab.c"
+    break;
+
+  case 15: /* subr_decl_sec_optional: %empty  */
+#line 156 "rascal_parser.y"
+                                    {(yyval.subRotDecl) = NULL;}
+#line 1614 "rascal_parser.tab.c"
+    break;
+
+  case 16: /* subr_decl_sec: subr_decl ';'  */
+#line 160 "rascal_parser.y"
+                                    {(yyval.subRotDeclChain) = newSubRotDeclarationChain((yyvsp[-1].subRotDecl));}
+#line 1620 "rascal_parser.tab.c"
+    break;
+
+  case 17: /* subr_decl_sec: subr_decl_sec subr_decl ';'  */
+#line 161 "rascal_parser.y"
+                                    {(yyval.subRotDeclChain) = addSubRotDeclaration((yyvsp[-2].subRotDeclChain), (yyvsp[-1].subRotDecl));}
+#line 1626 "rascal_parser.tab.c"
+    break;
+
+  case 18: /* subr_decl: proc_decl  */
+#line 165 "rascal_parser.y"
+                                    {(yyval.subRotDecl) = (yyvsp[0].subRotDecl);}
+#line 1632 "rascal_parser.tab.c"
+    break;
+
+  case 19: /* subr_decl: func_decl  */
+#line 166 "rascal_parser.y"
+                                    {(yyval.subRotDecl) = (yyvsp[0].subRotDecl);}
+#line 1638 "rascal_parser.tab.c"
+    break;
+
+  case 20: /* proc_decl: PROCEDURE ID form_param_optional ';' subr_block  */
+#line 170 "rascal_parser.y"
+                                                                {(yyval.subRotDecl) = newProcDeclaration(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[-3].slice)), (yyvsp[-2].varDecl), (yyvsp[0].subRotBlock));}
+#line 1644 "rascal_parser.tab.c"
+    break;
+
+  case 21: /* func_decl: FUNCTION ID form_param_optional ':' type ';' subr_block  */
+#line 174 "rascal_parser.y"
+                                                                {(yyval.subRotDecl) = newFuncDeclaration(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[-5].slice)), (yyvsp[-4].varDecl), (yyvsp[-2].vType), (yyvsp[0].subRotBlock));}
+#line 1650 "rascal_parser.tab.c"
+    break;
+
+  case 22: /* form_param_optional: form_param  */
+#line 178 "rascal_parser.y"
+                                    {(yyval.varDecl) = (yyvsp[0].varDecl);}
+#line 1656 "rascal_parser.tab.c"
+    break;
+
+  case 23: /* form_param_optional: %empty  */
+#line 179 "rascal_parser.y"
+                                    {(yyval.varDecl) = NULL;}
+#line 1662 "rascal_parser.tab.c"
+    break;
+
+  case 24: /* form_param: '(' form_param_list ')'  */
+#line 183 "rascal_parser.y"
+                                    {(yyval.varDecl) = (yyvsp[-1].varDeclChain).head;}
+#line 1668 "rascal_parser.tab.c"
+    break;
+
+  case 25: /* form_param_list: var_decl  */
+#line 187 "rascal_parser.y"
+                                    {(yyval.varDeclChain) = newVarDeclarationChain((yyvsp[0].varDecl));}
+#line 1674 "rascal_parser.tab.c"
+    break;
+
+  case 26: /* form_param_list: form_param_list ';' var_decl  */
+#line 188 "rascal_parser.y"
+                                    {(yyval.varDeclChain) = addVarDeclaration((yyvsp[-2].varDeclChain), (yyvsp[0].varDecl));}
+#line 1680 "rascal_parser.tab.c"
+    break;
+
+  case 27: /* subr_block: var_decl_sec_optional compound_cmd  */
+#line 192 "rascal_parser.y"
+                                                                {(yyval.subRotBlock) = newSubRotBlock(&comp->astArena, (yyvsp[-1].varDecl), (yyvsp[0].cmd));}
+#line 1686 "rascal_parser.tab.c"
+    break;
+
+  case 28: /* compound_cmd: TBEGIN cmd_list END  */
+#line 196 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[-1].cmdChain).head;}
+#line 1692 "rascal_parser.tab.c"
+    break;
+
+  case 29: /* cmd_list: cmd  */
+#line 200 "rascal_parser.y"
+                                    {(yyval.cmdChain) = newCommandChain((yyvsp[0].cmd));}
+#line 1698 "rascal_parser.tab.c"
+    break;
+
+  case 30: /* cmd_list: cmd_list ';' cmd  */
+#line 201 "rascal_parser.y"
+                                    {(yyval.cmdChain) = addCommand((yyvsp[-2].cmdChain), (yyvsp[0].cmd));}
+#line 1704 "rascal_parser.tab.c"
+    break;
+
+  case 31: /* cmd: assign_cmd  */
+#line 205 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1710 "rascal_parser.tab.c"
+    break;
+
+  case 32: /* cmd: proc_call_cmd  */
+#line 206 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1716 "rascal_parser.tab.c"
+    break;
+
+  case 33: /* cmd: cond_cmd  */
+#line 207 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1722 "rascal_parser.tab.c"
+    break;
+
+  case 34: /* cmd: loop_cmd  */
+#line 208 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1728 "rascal_parser.tab.c"
+    break;
+
+  case 35: /* cmd: read_cmd  */
+#line 209 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1734 "rascal_parser.tab.c"
+    break;
+
+  case 36: /* cmd: write_cmd  */
+#line 210 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1740 "rascal_parser.tab.c"
+    break;
+
+  case 37: /* cmd: compound_cmd  */
+#line 211 "rascal_parser.y"
+                                    {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1746 "rascal_parser.tab.c"
+    break;
+
+  case 38: /* assign_cmd: ID ASSIGN expr  */
+#line 215 "rascal_parser.y"
+                                    {(yyval.cmd) = newAssignCommand(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[-2].slice)), (yyvsp[0].expr));}
+#line 1752 "rascal_parser.tab.c"
+    break;
+
+  case 39: /* proc_call_cmd: ID '(' expr_list_optional ')'  */
+#line 219 "rascal_parser.y"
+                                    {(yyval.cmd) = newProcCallCommand(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[-3].slice)), (yyvsp[-1].expr));}
+#line 1758 "rascal_parser.tab.c"
+    break;
+
+  case 40: /* cond_cmd: IF expr THEN cmd else_part_optional  */
+#line 223 "rascal_parser.y"
+                                                                {(yyval.cmd) = newCondCommand(&comp->astArena, (yyvsp[-3].expr), (yyvsp[-1].cmd), (yyvsp[0].cmd));}
+#line 1764 "rascal_parser.tab.c"
+    break;
+
+  case 41: /* else_part_optional: ELSE cmd  */
+#line 227 "rascal_parser.y"
+                                                                {(yyval.cmd) = (yyvsp[0].cmd);}
+#line 1770 "rascal_parser.tab.c"
+    break;
+
+  case 42: /* else_part_optional: %empty  */
+#line 228 "rascal_parser.y"
+                                                                {(yyval.cmd) = NULL;}
+#line 1776 "rascal_parser.tab.c"
+    break;
+
+  case 43: /* loop_cmd: WHILE expr DO cmd  */
+#line 232 "rascal_parser.y"
+                                    {(yyval.cmd) = newLoopCommand(&comp->astArena, (yyvsp[-2].expr), (yyvsp[0].cmd));}
+#line 1782 "rascal_parser.tab.c"
+    break;
+
+  case 44: /* read_cmd: READ '(' id_list ')'  */
+#line 236 "rascal_parser.y"
+                                    {(yyval.cmd) = newReadCommand(&comp->astArena, (yyvsp[-1].idChain).head);}
+#line 1788 "rascal_parser.tab.c"
+    break;
+
+  case 45: /* write_cmd: WRITE '(' expr_list ')'  */
+#line 240 "rascal_parser.y"
+                                    {(yyval.cmd) = newWriteCommand(&comp->astArena, (yyvsp[-1].exprChain).head);}
+#line 1794 "rascal_parser.tab.c"
+    break;
+
+  case 46: /* expr_list_optional: expr_list  */
+#line 244 "rascal_parser.y"
+                                    {(yyval.expr) = (yyvsp[0].exprChain).head;}
+#line 1800 "rascal_parser.tab.c"
+    break;
+
+  case 47: /* expr_list_optional: %empty  */
+#line 245 "rascal_parser.y"
+                                    {(yyval.expr) = NULL;}
+#line 1806 "rascal_parser.tab.c"
+    break;
+
+  case 48: /* expr_list: expr  */
+#line 249 "rascal_parser.y"
+                                    {(yyval.exprChain) = newExpressionChain((yyvsp[0].expr));}
+#line 1812 "rascal_parser.tab.c"
+    break;
+
+  case 49: /* expr_list: expr_list ',' expr  */
+#line 250 "rascal_parser.y"
+                                    {(yyval.exprChain) = addExpression((yyvsp[-2].exprChain), (yyvsp[0].expr));}
+#line 1818 "rascal_parser.tab.c"
+    break;
+
+  case 50: /* expr: simple_expr  */
+#line 254 "rascal_parser.y"
+                                                                {(yyval.expr) = (yyvsp[0].expr);}
+#line 1824 "rascal_parser.tab.c"
+    break;
+
+  case 51: /* expr: simple_expr relational simple_expr  */
+#line 255 "rascal_parser.y"
+                                                                {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), (yyvsp[-1].op), (yyvsp[0].expr));}
+#line 1830 "rascal_parser.tab.c"
+    break;
+
+  case 52: /* relational: '='  */
+#line 259 "rascal_parser.y"
+                                    {(yyval.op) = Equal;}
+#line 1836 "rascal_parser.tab.c"
+    break;
+
+  case 53: /* relational: DIF  */
+#line 260 "rascal_parser.y"
+                                    {(yyval.op) = Different;}
+#line 1842 "rascal_parser.tab.c"
+    break;
+
+  case 54: /* relational: '<'  */
+#line 261 "rascal_parser.y"
+                                    {(yyval.op) = Less;}
+#line 1848 "rascal_parser.tab.c"
+    break;
+
+  case 55: /* relational: LTE  */
+#line 262 "rascal_parser.y"
+                                    {(yyval.op) = LessEqual;}
+#line 1854 "rascal_parser.tab.c"
+    break;
+
+  case 56: /* relational: '>'  */
+#line 263 "rascal_parser.y"
+                                    {(yyval.op) = Greater;}
+#line 1860 "rascal_parser.tab.c"
+    break;
+
+  case 57: /* relational: GTE  */
+#line 264 "rascal_parser.y"
+                                    {(yyval.op) = GreaterEqual;}
+#line 1866 "rascal_parser.tab.c"
+    break;
+
+  case 58: /* simple_expr: term  */
+#line 268 "rascal_parser.y"
+                                    {(yyval.expr) = (yyvsp[0].expr);}
+#line 1872 "rascal_parser.tab.c"
+    break;
+
+  case 59: /* simple_expr: '+' term  */
+#line 269 "rascal_parser.y"
+                                    {(yyval.expr) = (yyvsp[0].expr);}
+#line 1878 "rascal_parser.tab.c"
+    break;
+
+  case 60: /* simple_expr: '-' term  */
+#line 270 "rascal_parser.y"
+                                    {(yyval.expr) = newUnaryExpression(&comp->astArena, Minus, (yyvsp[0].expr));}
+#line 1884 "rascal_parser.tab.c"
+    break;
+
+  case 61: /* simple_expr: simple_expr '+' term  */
+#line 271 "rascal_parser.y"
+                                    {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), Plus, (yyvsp[0].expr));}
+#line 1890 "rascal_parser.tab.c"
+    break;
+
+  case 62: /* simple_expr: simple_expr '-' term  */
+#line 272 "rascal_parser.y"
+                                    {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), Minus, (yyvsp[0].expr));}
+#line 1896 "rascal_parser.tab.c"
+    break;
+
+  case 63: /* simple_expr: simple_expr OR term  */
+#line 273 "rascal_parser.y"
+                                    {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), Or, (yyvsp[0].expr));}
+#line 1902 "rascal_parser.tab.c"
+    break;
+
+  case 64: /* term: factor  */
+#line 277 "rascal_parser.y"
+                                    {(yyval.expr) = (yyvsp[0].expr);}
+#line 1908 "rascal_parser.tab.c"
+    break;
+
+  case 65: /* term: term '*' factor  */
+#line 278 "rascal_parser.y"
+                                    {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), Multiplication, (yyvsp[0].expr));}
+#line 1914 "rascal_parser.tab.c"
+    break;
+
+  case 66: /* term: term DIV factor  */
+#line 279 "rascal_parser.y"
+                                    {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), Division, (yyvsp[0].expr));}
+#line 1920 "rascal_parser.tab.c"
+    break;
+
+  case 67: /* term: term AND factor  */
+#line 280 "rascal_parser.y"
+                                    {(yyval.expr) = newBinaryExpression(&comp->astArena, (yyvsp[-2].expr), And, (yyvsp[0].expr));}
+#line 1926 "rascal_parser.tab.c"
+    break;
+
+  case 68: /* factor: variable  */
+#line 284 "rascal_parser.y"
+                                    {(yyval.expr) = newVariableExpression(&comp->astArena, (yyvsp[0].sval));}
+#line 1932 "rascal_parser.tab.c"
+    break;
+
+  case 69: /* factor: NUM  */
+#line 285 "rascal_parser.y"
+                                    {(yyval.expr) = newConstantIntegerExpression(&comp->astArena, (yyvsp[0].ival));}
+#line 1938 "rascal_parser.tab.c"
+    break;
+
+  case 70: /* factor: logical  */
+#line 286 "rascal_parser.y"
+                                    {(yyval.expr) = newConstantBooleanExpression(&comp->astArena, (yyvsp[0].boolVal));}
+#line 1944 "rascal_parser.tab.c"
+    break;
+
+  case 71: /* factor: func_call  */
+#line 287 "rascal_parser.y"
+                                    {(yyval.expr) = (yyvsp[0].expr);}
+#line 1950 "rascal_parser.tab.c"
+    break;
+
+  case 72: /* factor: '(' expr ')'  */
+#line 288 "rascal_parser.y"
+                                    {(yyval.expr) = (yyvsp[-1].expr);}
+#line 1956 "rascal_parser.tab.c"
+    break;
+
+  case 73: /* factor: NOT factor  */
+#line 289 "rascal_parser.y"
+                                    {(yyval.expr) = newUnaryExpression(&comp->astArena, Not, (yyvsp[0].expr));}
+#line 1962 "rascal_parser.tab.c"
+    break;
+
+  case 74: /* variable: ID  */
+#line 293 "rascal_parser.y"
+                                    {(yyval.sval) = sliceToIdentifier(&comp->identifiers, (yyvsp[0].slice));}
+#line 1968 "rascal_parser.tab.c"
+    break;
+
+  case 75: /* logical: TTRUE  */
+#line 297 "rascal_parser.y"
+                                    {(yyval.boolVal) = BoolTrue;}
+#line 1974 "rascal_parser.tab.c"
+    break;
+
+  case 76: /* logical: TFALSE  */
+#line 298 "rascal_parser.y"
+                                    {(yyval.boolVal) = BoolFalse;}
+#line 1980 "rascal_parser.tab.c"
+    break;
+
+  case 77: /* func_call: ID '(' expr_list_optional ')'  */
+#line 302 "rascal_parser.y"
+                                    {(yyval.expr) = newFunctionCallExpression(&comp->astArena, sliceToIdentifier(&comp->identifiers, (yyvsp[-3].slice)), (yyvsp[-1].expr));}
+#line 1986 "rascal_parser.tab.c"
+    break;
+
+
+#line 1990 "rascal_parser.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (comp, scanner, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, comp, scanner);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, comp, scanner);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (comp, scanner, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, comp, scanner);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, comp, scanner);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
+}
+
+#line 305 "rascal_parser.y"
+
+
+void yyerror(Compilation* comp, yyscan_t scanner, const char *s){
+    reportError(comp, RASCAL_SYNTAX_ERROR, yyget_lineno(scanner), "%s", s);
+}
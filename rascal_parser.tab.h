@@ -0,0 +1,145 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_RASCAL_PARSER_TAB_H_INCLUDED
+# define YY_YY_RASCAL_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+/* "%code requires" blocks.  */
+#line 8 "rascal_parser.y"
+
+    #include "rascal_ast.h"
+
+    typedef struct Compilation Compilation;
+
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void* yyscan_t;
+    #endif
+
+#line 60 "rascal_parser.tab.h"
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    PROGRAM = 258,                 /* PROGRAM  */
+    TBEGIN = 259,                  /* TBEGIN  */
+    END = 260,                     /* END  */
+    PROCEDURE = 261,               /* PROCEDURE  */
+    FUNCTION = 262,                /* FUNCTION  */
+    VAR = 263,                     /* VAR  */
+    INTEGER = 264,                 /* INTEGER  */
+    BOOLEAN = 265,                 /* BOOLEAN  */
+    TFALSE = 266,                  /* TFALSE  */
+    TTRUE = 267,                   /* TTRUE  */
+    WHILE = 268,                   /* WHILE  */
+    DO = 269,                      /* DO  */
+    IF = 270,                      /* IF  */
+    THEN = 271,                    /* THEN  */
+    ELSE = 272,                    /* ELSE  */
+    READ = 273,                    /* READ  */
+    WRITE = 274,                   /* WRITE  */
+    AND = 275,                     /* AND  */
+    OR = 276,                      /* OR  */
+    NOT = 277,                     /* NOT  */
+    DIV = 278,                     /* DIV  */
+    DIF = 279,                     /* DIF  */
+    LTE = 280,                     /* LTE  */
+    GTE = 281,                     /* GTE  */
+    ASSIGN = 282,                  /* ASSIGN  */
+    ID = 283,                      /* ID  */
+    NUM = 284,                     /* NUM  */
+    LOWER_THAN_ELSE = 285          /* LOWER_THAN_ELSE  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 32 "rascal_parser.y"
+
+    Program* prog;
+    Block* block;
+    VarDeclaration* varDecl;
+    IdentifierList* idList;
+    SubRotDeclaration* subRotDecl;
+    SubRotBlock* subRotBlock;
+    Command* cmd;
+    Expression* expr;
+
+    VarDeclarationChain varDeclChain;
+    IdentifierChain idChain;
+    SubRotDeclarationChain subRotDeclChain;
+    CommandChain cmdChain;
+    ExpressionChain exprChain;
+
+    varType vType;
+    Operator op;
+    BooleanValue boolVal;
+
+    int ival;
+    char* sval;
+    Slice slice;
+
+#line 132 "rascal_parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+
+
+int yyparse (Compilation* comp, yyscan_t scanner);
+
+
+#endif /* !YY_YY_RASCAL_PARSER_TAB_H_INCLUDED  */
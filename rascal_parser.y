@@ -2,66 +2,75 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "rascal_ast.h"
-
-int yylex(void);
-void yyerror(const char *s);
-extern int yylineno;
-
-Program* ast_root = NULL;
+#include "compilation.h"
 %}
 
 %code requires {
-    #include "rascal_ast.h"
+    #include "rascal_build.h"
+
+    typedef struct Compilation Compilation;
+
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void* yyscan_t;
+    #endif
+}
+
+%code {
+    int yylex(YYSTYPE* yylval_param, yyscan_t scanner);
+    void yyerror(Compilation* comp, yyscan_t scanner, const char *s);
+    int yyget_lineno(yyscan_t scanner);
 }
 
 %define parse.error verbose
 
+// Pure parser: AST nodes and identifiers go to the compilation, built
+// in its layout (see rascal_build.h)
+%define api.pure full
+%parse-param {Compilation* comp} {yyscan_t scanner}
+%lex-param {yyscan_t scanner}
+
 %union {
-    Program* prog;
-    Block* block;
-    VarDeclaration* varDecl;
-    IdentifierList* idList;
-    SubRotDeclaration* subRotDecl;
-    SubRotBlock* subRotBlock;
-    Command* cmd;
-    Expression* expr;
+    AstRef node;
+    AstChain chain;
 
     varType vType;
     Operator op;
     BooleanValue boolVal;
 
     int ival;
-    char* sval;
+    Slice slice;
 }
 
 %token PROGRAM TBEGIN END PROCEDURE FUNCTION VAR INTEGER BOOLEAN TFALSE TTRUE WHILE DO IF THEN ELSE READ WRITE AND OR NOT DIV DIF LTE GTE ASSIGN
-%token <sval> ID
+%token <slice> ID
 %token <ival> NUM
 
-// Program
-%type <prog> program
-
 // Block
-%type <block> block
+%type <node> block
 
 // Variable Declarations Section
-%type <varDecl> var_decl_sec_optional var_decl_sec var_decl var_decl_list
-%type <idList> id_list
+%type <node> var_decl_sec_optional var_decl_sec var_decl
+%type <chain> var_decl_list
+%type <chain> id_list
 %type <vType> type;
 
 // Subroutine Declarations Section
-%type <subRotDecl> subr_decl_sec_optional subr_decl_sec subr_decl proc_decl func_decl
-%type <varDecl> form_param_optional form_param_list form_param
-%type <subRotBlock> subr_block;
+%type <node> subr_decl_sec_optional subr_decl proc_decl func_decl
+%type <chain> subr_decl_sec
+%type <node> form_param_optional form_param
+%type <chain> form_param_list
+%type <node> subr_block;
 
 // Commands Section
-%type <cmd> compound_cmd cmd_list cmd assign_cmd proc_call_cmd cond_cmd else_part_optional loop_cmd read_cmd write_cmd
+%type <node> compound_cmd cmd assign_cmd proc_call_cmd cond_cmd else_part_optional loop_cmd read_cmd write_cmd
+%type <chain> cmd_list
 
 // Expression Section
-%type <expr> expr_list_optional expr_list expr simple_expr term factor func_call
+%type <node> expr_list_optional expr simple_expr term factor func_call
+%type <chain> expr_list
 %type <op> relational;
-%type <sval> variable;
+%type <slice> variable;
 %type <boolVal> logical;
 
 %nonassoc '=' DIF '<' LTE '>' GTE
@@ -77,51 +86,41 @@ Program* ast_root = NULL;
 program
     : PROGRAM ID ';' block '.'
     { 
-        $$ = newProgram($2, $4);
-        ast_root = $$;
+        buildProgram(comp, $2, $4);
     }
     ;
 
 block
     : var_decl_sec_optional subr_decl_sec_optional compound_cmd 
     {
-        $$ = newBlock($1, $2, $3);
+        $$ = buildBlock(comp, $1, $2, $3);
     }
     ;
 
 var_decl_sec_optional
     : var_decl_sec                  {$$ = $1;}
-    | /* empty */                   {$$ = NULL;}
+    | /* empty */                   {$$ = AST_NONE;}
     ;
 
 var_decl_sec
-    : VAR var_decl_list             {$$ = $2;}
+    : VAR var_decl_list             {$$ = $2.head;}
     ;
 
 var_decl_list
-    : var_decl ';'                  {$$ = $1;}
-    | var_decl_list var_decl ';'    {$$ = addVarDeclaration($1, $2);}
+    : var_decl ';'                  {$$ = buildChain(comp, LIST_VARS, $1);}
+    | var_decl_list var_decl ';'    {$$ = buildAppend(comp, LIST_VARS, $1, $2);}
     ;
 
 var_decl
     : id_list ':' type  
     {
-        IdentifierList* it = $1;
-        VarDeclaration* list = NULL;
-        while (it) {
-            VarDeclaration* node = newVarDeclaration($3, it->identifier);
-            it->identifier = NULL; // identifier belongs to the new node
-            list = addVarDeclaration(list, node);
-            it = it->next;
-        }
-        freeIdentifierList($1);
-        $$ = list;
+        $$ = buildVarDeclarations(comp, $1, $3);
     }
     ;
 
 id_list
-    : ID                            {$$ = newIdentifierList($1);}
-    | id_list ',' ID                {$$ = addIdentifier($1, newIdentifierList($3));}
+    : ID                            {$$ = buildChain(comp, LIST_IDENTIFIERS, buildIdentifier(comp, $1));}
+    | id_list ',' ID                {$$ = buildAppend(comp, LIST_IDENTIFIERS, $1, buildIdentifier(comp, $3));}
     ;
 
 type
@@ -130,13 +129,13 @@ type
     ;
 
 subr_decl_sec_optional
-    : subr_decl_sec                 {$$ = $1;}
-    | /* empty */                   {$$ = NULL;}
+    : subr_decl_sec                 {$$ = $1.head;}
+    | /* empty */                   {$$ = AST_NONE;}
     ;
 
 subr_decl_sec
-    : subr_decl ';'                 {$$ = $1;}
-    | subr_decl_sec subr_decl ';'   {$$ = addSubRotDeclaration($1, $2);}
+    : subr_decl ';'                 {$$ = buildChain(comp, LIST_SUBROUTINES, $1);}
+    | subr_decl_sec subr_decl ';'   {$$ = buildAppend(comp, LIST_SUBROUTINES, $1, $2);}
     ;
 
 subr_decl
@@ -145,38 +144,38 @@ subr_decl
     ;
 
 proc_decl
-    : PROCEDURE ID form_param_optional ';' subr_block           {$$ = newProcDeclaration($2, $3, $5);}
+    : PROCEDURE ID form_param_optional ';' subr_block           {$$ = buildProcDeclaration(comp, $2, $3, $5);}
     ;
 
 func_decl
-    : FUNCTION ID form_param_optional ':' type ';' subr_block   {$$ = newFuncDeclaration($2, $3, $5, $7);}
+    : FUNCTION ID form_param_optional ':' type ';' subr_block   {$$ = buildFuncDeclaration(comp, $2, $3, $5, $7);}
     ;
 
 form_param_optional
     : form_param                    {$$ = $1;}
-    | /* empty */                   {$$ = NULL;}
+    | /* empty */                   {$$ = AST_NONE;}
     ;
 
 form_param
-    : '(' form_param_list ')'       {$$ = $2;}
+    : '(' form_param_list ')'       {$$ = $2.head;}
     ;
 
 form_param_list
-    : var_decl                      {$$ = $1;}
-    | form_param_list ';' var_decl  {$$ = addVarDeclaration($1, $3);}
+    : var_decl                      {$$ = buildChain(comp, LIST_VARS, $1);}
+    | form_param_list ';' var_decl  {$$ = buildAppend(comp, LIST_VARS, $1, $3);}
     ;
 
 subr_block
-    : var_decl_sec_optional compound_cmd                        {$$ = newSubRotBlock($1, $2);}
+    : var_decl_sec_optional compound_cmd                        {$$ = buildSubRotBlock(comp, $1, $2);}
     ;
 
 compound_cmd
-    : TBEGIN cmd_list END           {$$ = $2;}
+    : TBEGIN cmd_list END           {$$ = $2.head;}
     ;
 
 cmd_list
-    : cmd                           {$$ = $1;}
-    | cmd_list ';' cmd              {$$ = addCommand($1, $3);}
+    : cmd                           {$$ = buildChain(comp, LIST_COMMANDS, $1);}
+    | cmd_list ';' cmd              {$$ = buildAppend(comp, LIST_COMMANDS, $1, $3);}
     ;
 
 cmd
@@ -190,47 +189,47 @@ cmd
     ;
 
 assign_cmd
-    : ID ASSIGN expr                {$$ = newAssignCommand($1, $3);}
+    : ID ASSIGN expr                {$$ = buildAssignCommand(comp, $1, $3);}
     ;
 
 proc_call_cmd
-    : ID '(' expr_list_optional ')' {$$ = newProcCallCommand($1, $3);}
+    : ID '(' expr_list_optional ')' {$$ = buildProcCallCommand(comp, $1, $3);}
     ;
 
 cond_cmd
-    : IF expr THEN cmd else_part_optional                       {$$ = newCondCommand($2, $4, $5);}
+    : IF expr THEN cmd else_part_optional                       {$$ = buildCondCommand(comp, $2, $4, $5);}
     ;
 
 else_part_optional
     : ELSE cmd                                                  {$$ = $2;}
-    | /* empty */ %prec LOWER_THAN_ELSE                         {$$ = NULL;}
+    | /* empty */ %prec LOWER_THAN_ELSE                         {$$ = AST_NONE;}
     ;
 
 loop_cmd
-    : WHILE expr DO cmd             {$$ = newLoopCommand($2, $4);}
+    : WHILE expr DO cmd             {$$ = buildLoopCommand(comp, $2, $4);}
     ;
 
 read_cmd
-    : READ '(' id_list ')'          {$$ = newReadCommand($3);}
+    : READ '(' id_list ')'          {$$ = buildReadCommand(comp, $3);}
     ;
 
 write_cmd
-    : WRITE '(' expr_list ')'       {$$ = newWriteCommand($3);}
+    : WRITE '(' expr_list ')'       {$$ = buildWriteCommand(comp, $3.head);}
     ;
 
 expr_list_optional
-    : expr_list                     {$$ = $1;}
-    | /* empty */                   {$$ = NULL;}
+    : expr_list                     {$$ = $1.head;}
+    | /* empty */                   {$$ = AST_NONE;}
     ;
 
 expr_list
-    : expr                          {$$ = $1;}
-    | expr_list ',' expr            {$$ = addExpression($1, $3);}
+    : expr                          {$$ = buildChain(comp, LIST_EXPRESSIONS, $1);}
+    | expr_list ',' expr            {$$ = buildAppend(comp, LIST_EXPRESSIONS, $1, $3);}
     ;
 
 expr
     : simple_expr                                               {$$ = $1;}
-    | simple_expr relational simple_expr                        {$$ = newBinaryExpression($1, $2, $3);}
+    | simple_expr relational simple_expr                        {$$ = buildBinaryExpression(comp, $1, $2, $3);}
     ;
 
 relational
@@ -245,26 +244,26 @@ relational
 simple_expr
     : term                          {$$ = $1;}
     | '+' term                      {$$ = $2;}
-    | '-' term                      {$$ = newUnaryExpression(Minus, $2);}
-    | simple_expr '+' term          {$$ = newBinaryExpression($1, Plus, $3);}
-    | simple_expr '-' term          {$$ = newBinaryExpression($1, Minus, $3);}
-    | simple_expr OR term           {$$ = newBinaryExpression($1, Or, $3);}
+    | '-' term                      {$$ = buildUnaryExpression(comp, Minus, $2);}
+    | simple_expr '+' term          {$$ = buildBinaryExpression(comp, $1, Plus, $3);}
+    | simple_expr '-' term          {$$ = buildBinaryExpression(comp, $1, Minus, $3);}
+    | simple_expr OR term           {$$ = buildBinaryExpression(comp, $1, Or, $3);}
     ;
 
 term
     : factor                        {$$ = $1;}
-    | term '*' factor               {$$ = newBinaryExpression($1, Multiplication, $3);}
-    | term DIV factor               {$$ = newBinaryExpression($1, Division, $3);}
-    | term AND factor               {$$ = newBinaryExpression($1, And, $3);}
+    | term '*' factor               {$$ = buildBinaryExpression(comp, $1, Multiplication, $3);}
+    | term DIV factor               {$$ = buildBinaryExpression(comp, $1, Division, $3);}
+    | term AND factor               {$$ = buildBinaryExpression(comp, $1, And, $3);}
     ;
 
 factor
-    : variable                      {$$ = newVariableExpression($1);}
-    | NUM                           {$$ = newConstantIntegerExpression($1);}
-    | logical                       {$$ = newConstantBooleanExpression($1);}
+    : variable                      {$$ = buildVariableExpression(comp, $1);}
+    | NUM                           {$$ = buildConstantIntegerExpression(comp, $1);}
+    | logical                       {$$ = buildConstantBooleanExpression(comp, $1);}
     | func_call                     {$$ = $1;}
     | '(' expr ')'                  {$$ = $2;}
-    | NOT factor                    {$$ = newUnaryExpression(Not, $2);}
+    | NOT factor                    {$$ = buildUnaryExpression(comp, Not, $2);}
     ;
 
 variable
@@ -277,11 +276,11 @@ logical
     ;
 
 func_call
-    : ID '(' expr_list_optional ')' {$$ = newFunctionCallExpression($1, $3);}
+    : ID '(' expr_list_optional ')' {$$ = buildFunctionCallExpression(comp, $1, $3);}
     ;
 
 %%
 
-void yyerror(const char *s){
-    printf("\nSyntatic error in line %d: %s\n", yylineno, s);
+void yyerror(Compilation* comp, yyscan_t scanner, const char *s){
+    reportError(comp, RASCAL_SYNTAX_ERROR, yyget_lineno(scanner), "%s", s);
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "rascal_source.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Space flex needs after the text for its end of buffer markers
+#define SOURCE_PADDING 2
+
+// Maps a regular file so the lexer can scan it without copies.
+// An anonymous zero filled region is reserved first and the file
+// is mapped over its beginning, so the padding bytes are always
+// readable even when the file size is a multiple of the page size.
+// The mapping is private and writable because flex temporarily
+// writes a NUL after each token.
+static int mapSource(SourceBuffer* src, int fd, size_t size) {
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t mapLength = (size + SOURCE_PADDING + pageSize - 1) / pageSize * pageSize;
+
+    char* base = mmap(NULL, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return 0;
+
+    if (size > 0) {
+        void* file = mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (file == MAP_FAILED) {
+            munmap(base, mapLength);
+            return 0;
+        }
+    }
+
+    src->text = base;
+    src->length = size;
+    src->mapLength = mapLength;
+    return 1;
+}
+
+// Reads the whole stream for inputs that can not be mapped (pipes, devices)
+static int readSource(SourceBuffer* src, int fd) {
+    size_t capacity = 1 << 16;
+    size_t length = 0;
+    char* text = (char*) malloc(capacity);
+    if (!text) return 0;
+
+    for (;;) {
+        if (capacity - length < SOURCE_PADDING + 1) {
+            capacity *= 2;
+            char* grown = (char*) realloc(text, capacity);
+            if (!grown) {
+                free(text);
+                return 0;
+            }
+            text = grown;
+        }
+
+        ssize_t n = read(fd, text + length, capacity - length - SOURCE_PADDING);
+        if (n < 0) {
+            free(text);
+            return 0;
+        }
+        if (n == 0) break;
+        length += (size_t) n;
+    }
+
+    memset(text + length, 0, SOURCE_PADDING);
+    src->text = text;
+    src->length = length;
+    src->mapLength = 0;
+    return 1;
+}
+
+// Opens the source file, mapping it when possible
+int openSourceBuffer(SourceBuffer* src, const char* path) {
+    memset(src, 0, sizeof(*src));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    int ok = 0;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+        ok = mapSource(src, fd, (size_t) st.st_size);
+    if (!ok)
+        ok = readSource(src, fd);
+
+    close(fd);
+    return ok;
+}
+
+// Copies source text held in memory (flex writes into the buffer it scans)
+int copySourceBuffer(SourceBuffer* src, const char* text, size_t length) {
+    memset(src, 0, sizeof(*src));
+
+    src->text = (char*) malloc(length + SOURCE_PADDING);
+    if (!src->text) return 0;
+
+    memcpy(src->text, text, length);
+    memset(src->text + length, 0, SOURCE_PADDING);
+    src->length = length;
+    return 1;
+}
+
+// Releases the source text
+void closeSourceBuffer(SourceBuffer* src) {
+    if (!src->text) return;
+
+    if (src->mapLength)
+        munmap(src->text, src->mapLength);
+    else
+        free(src->text);
+
+    src->text = NULL;
+    src->length = 0;
+    src->mapLength = 0;
+}
@@ -0,0 +1,20 @@
+#ifndef RASCAL_SOURCE_H
+#define RASCAL_SOURCE_H
+
+#include <stddef.h>
+
+// Source text of a compilation, scanned in place by the lexer.
+// The buffer always ends with the two NUL bytes flex requires
+// after the text (length does not count them).
+typedef struct SourceBuffer {
+    char* text;
+    size_t length;
+    size_t mapLength;   // Bytes mapped, 0 when the text lives on the heap
+} SourceBuffer;
+
+// Source buffer functions
+int openSourceBuffer(SourceBuffer* src, const char* path);
+int copySourceBuffer(SourceBuffer* src, const char* text, size_t length);
+void closeSourceBuffer(SourceBuffer* src);
+
+#endif
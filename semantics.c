@@ -1,18 +1,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <setjmp.h>
 
 #include "semantics.h"
 #include "rascal_ast.h"
 #include "symbol_table.h"
 
-// Global list containing all subroutines declared in the program
-static SubRotDeclaration *globalSubrotList = NULL;
+// Keeps the semantic analysis context
+typedef struct SemanticContext {
+    SymbolTable symbols;
+    Compilation *comp;
+    jmp_buf failure;                // Where an error abandons the analysis
+} SemanticContext;
 
 // Auxliar function for printing semantic error
-static void semanticError(const char *msg) {
-    printf("\nSemantic error: %s\n", msg);
-    exit(1);
+static void semanticError(SemanticContext *ctx, const char *msg) {
+    reportError(ctx->comp, RASCAL_SEMANTIC_ERROR, 0, "%s", msg);
+    longjmp(ctx->failure, 1);
+}
+
+// Auxiliar function for declaring an identifier in the current scope
+static Symbol *declare(char *name, Category cat, Type type, SemanticContext *ctx) {
+    Symbol *sym = install(&ctx->symbols, name, cat, type, ctx->symbols.current_scope->level);
+    if (!sym) {
+        reportError(ctx->comp, RASCAL_SEMANTIC_ERROR, 0, "identifier '%s' declared twice in the same scope.", name);
+        longjmp(ctx->failure, 1);
+    }
+    return sym;
 }
 
 // Auxiliar function for conversion
@@ -24,90 +39,201 @@ static Type varTypeToType(varType vt) {
     }
 }
 
+// Auxiliar function for annotating the AST with a resolved symbol
+static Binding bindingOf(Symbol *sym) {
+    Binding b;
+    b.level = sym->level;
+    b.offset = sym->offset;
+    return b;
+}
+
+// Name resolution, the same for both layouts: each looks a name up and
+// fails unless it may be used where it appears
+static Symbol *assignedSymbol(char *name, SemanticContext *ctx) {
+    Symbol *sym = lookup(&ctx->symbols, name);
+    if (!sym) semanticError(ctx, "assignment for undeclared identifier.");
+
+    if (sym->category != CAT_VAR && sym->category != CAT_PARAM)
+        semanticError(ctx, "left side of the assignment must be a variable or parameter.");
+    return sym;
+}
+
+static Symbol *readSymbol(char *name, SemanticContext *ctx) {
+    Symbol *sym = lookup(&ctx->symbols, name);
+
+    if (!sym)
+        semanticError(ctx, "read identifier was not declared.");
+
+    if (sym->category != CAT_VAR && sym->category != CAT_PARAM)
+        semanticError(ctx, "argument of READ must be a variable or a parameter.");
+    return sym;
+}
+
+static Symbol *variableSymbol(char *name, SemanticContext *ctx) {
+    Symbol *sym = lookup(&ctx->symbols, name);
+    if (!sym) semanticError(ctx, "use of not declared variable.");
+
+    if (sym->category != CAT_VAR && sym->category != CAT_PARAM)
+        semanticError(ctx, "only variables or parameters can appear in expressions.");
+    return sym;
+}
+
+static Signature *procedureSignature(char *name, SemanticContext *ctx) {
+    Symbol *sym = lookup(&ctx->symbols, name);
+    if (!sym) semanticError(ctx, "not declared procedure call.");
+
+    if (sym->category != CAT_PROCEDURE)
+        semanticError(ctx, "identifier called as a procedure is not a procedure.");
+
+    if (!sym->signature) semanticError(ctx, "declaration of the procedure was not found.");
+    return sym->signature;
+}
+
+static Signature *functionSignature(char *name, SemanticContext *ctx) {
+    Symbol *sym = lookup(&ctx->symbols, name);
+    if (!sym) semanticError(ctx, "not declared function call.");
+
+    if (sym->category != CAT_FUNCTION)
+        semanticError(ctx, "identifier called as a function is not a function.");
+
+    if (!sym->signature) semanticError(ctx, "function was not found.");
+    return sym->signature;
+}
+
 // Internal Declarations
-static void checkProgram(Program *p);
-static void checkBlock(Block *b);
-static void checkVarDeclarations(VarDeclaration *list, int asParams);
-static void predeclareSubroutines(SubRotDeclaration *list);
-static void checkSubroutines(SubRotDeclaration *list);
-static void checkSubroutine(SubRotDeclaration *srd);
-static void checkSubroutineBlock(SubRotBlock *srb, const char *funcName, int isFunction, int *returnCount);
-static void checkCommandList(Command *list, const char *currentFuncName, int *returnCount);
-static void checkCommand(Command *cmd, const char *currentFuncName, int *returnCount);
-static void checkAssignCommand(Command *cmd, const char *currentFuncName, int *returnCount);
-static void checkProcCallCommand(Command *cmd);
-static void checkConditionalCommand(Command *cmd, const char *currentFuncName, int *returnCount);
-static void checkLoopCommand(Command *cmd, const char *currentFuncName, int *returnCount);
-static void checkReadCommand(Command *cmd);
-static void checkWriteCommand(Command *cmd);
-static void checkExpressionList(Expression *list, VarDeclaration *formals);
-static Type checkExpression(Expression *e);
-static Type checkBinaryExpression(Expression *e);
-static Type checkUnaryExpression(Expression *e);
-static Type checkVariableExpression(Expression *e);
-static Type checkFunctionCallExpression(Expression *e);
-
-// Main Semantic Analysis Function
-void semanticCheck(Program *program) {
-    if (!program) semanticError("null program.\n");
-
-    enter_scope();
-    checkProgram(program);
-    leave_scope();
+static void checkProgram(Program *p, SemanticContext *ctx);
+static void checkBlock(Block *b, SemanticContext *ctx);
+static void checkVarDeclarations(VarDeclaration *list, int asParams, SemanticContext *ctx);
+static void predeclareSubroutines(SubRotDeclaration *list, SemanticContext *ctx);
+static void checkSubroutines(SubRotDeclaration *list, SemanticContext *ctx);
+static void checkSubroutine(SubRotDeclaration *srd, SemanticContext *ctx);
+static void checkSubroutineBlock(SubRotBlock *srb, const char *funcName, int isFunction, int *returnCount, SemanticContext *ctx);
+static void checkCommandList(Command *list, const char *currentFuncName, int *returnCount, SemanticContext *ctx);
+static void checkCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx);
+static void checkAssignCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx);
+static void checkProcCallCommand(Command *cmd, SemanticContext *ctx);
+static void checkConditionalCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx);
+static void checkLoopCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx);
+static void checkReadCommand(Command *cmd, SemanticContext *ctx);
+static void checkWriteCommand(Command *cmd, SemanticContext *ctx);
+static void checkExpressionList(Expression *list, const Signature *sig, SemanticContext *ctx);
+static Type checkExpression(Expression *e, SemanticContext *ctx);
+static Type checkBinaryExpression(Expression *e, SemanticContext *ctx);
+static Type checkUnaryExpression(Expression *e, SemanticContext *ctx);
+static Type binaryType(Operator op, Type lt, Type rt, SemanticContext *ctx);
+static Type unaryType(Operator op, Type rt, SemanticContext *ctx);
+static Type checkVariableExpression(Expression *e, SemanticContext *ctx);
+static Type checkFunctionCallExpression(Expression *e, SemanticContext *ctx);
+static void markPureSubroutines(SubRotDeclaration *list);
+static void checkFlatProgram(FlatAst *ast, SemanticContext *ctx);
+
+// Main Semantic Analysis Function: returns 0 when the program is valid
+int semanticCheck(Compilation *comp) {
+    SemanticContext ctx;
+    init_symbol_table(&ctx.symbols);
+    ctx.comp = comp;
+
+    if (setjmp(ctx.failure)) {
+        // Abandoned on the first error: drop the scopes still open
+        addSymbolTableStats(&comp->stats, &ctx.symbols);
+        free_symbol_table(&ctx.symbols);
+        return 1;
+    }
+
+    if (comp->flatAst ? !comp->flat.complete : !comp->astRoot) semanticError(&ctx, "null program.");
+
+    enter_scope(&ctx.symbols);
+    if (comp->flatAst)
+        checkFlatProgram(&comp->flat, &ctx);
+    else
+        checkProgram(comp->astRoot, &ctx);
+    leave_scope(&ctx.symbols);
+    addSymbolTableStats(&comp->stats, &ctx.symbols);
+    free_symbol_table(&ctx.symbols);
+    return 0;
 }
 
 // Program
-static void checkProgram(Program *p) {
+static void checkProgram(Program *p, SemanticContext *ctx) {
     // Install program name as global symbol
-    install(p->identifier, CAT_PROGRAM, TYPE_VOID, current_scope->level);
+    declare(p->identifier, CAT_PROGRAM, TYPE_VOID, ctx);
 
-    if (!p->block) semanticError("program without block.\n");
-
-    // Save reference to subroutines for later lookup
-    globalSubrotList = p->block->subRotDeclarations;
+    if (!p->block) semanticError(ctx, "program without block.");
 
     // Global declarations
-    checkVarDeclarations(p->block->varDeclarations, 0);
+    checkVarDeclarations(p->block->varDeclarations, 0, ctx);
 
     // Pre-declare all functions and procedures
-    predeclareSubroutines(p->block->subRotDeclarations);
+    predeclareSubroutines(p->block->subRotDeclarations, ctx);
 
     // Analyze subroutines bodies
-    checkSubroutines(p->block->subRotDeclarations);
+    checkSubroutines(p->block->subRotDeclarations, ctx);
+    markPureSubroutines(p->block->subRotDeclarations);
 
     // Analyze main block commands
-    checkBlock(p->block);
+    checkBlock(p->block, ctx);
 }
 
 // Block
-static void checkBlock(Block *b) {
+static void checkBlock(Block *b, SemanticContext *ctx) {
     if (!b) return;
 
     int dummy_return = 0;
-    checkCommandList(b->commandList, NULL, &dummy_return);
+    checkCommandList(b->commandList, NULL, &dummy_return, ctx);
 }
 
-// Variable and parameter declarations
-static void checkVarDeclarations(VarDeclaration *list, int asParams) {
+// Variable and parameter declarations. Parameters sit below the
+// MEPA frame of the subroutine, the first one closest to it
+static void checkVarDeclarations(VarDeclaration *list, int asParams, SemanticContext *ctx) {
     VarDeclaration *v = list;
+    int i = 0;
     while (v) {
-        install(v->identifier,
-                asParams ? CAT_PARAM : CAT_VAR,
-                varTypeToType(v->type), current_scope->level);
+        Symbol *sym = declare(v->identifier,
+                              asParams ? CAT_PARAM : CAT_VAR,
+                              varTypeToType(v->type), ctx);
+        if (asParams) sym->offset = -5 - i;
         v = v->next;
+        i++;
     }
 }
 
-// Subroutine pre-declaration
-static void predeclareSubroutines(SubRotDeclaration *list) {
+// Auxiliar function for allocating the signature of a subroutine,
+// whose parameter types the caller fills in
+static Signature *newSignature(int arity, Type returnType, SemanticContext *ctx) {
+    Signature *sig = (Signature*) arenaAlloc(&ctx->symbols.pool, sizeof(Signature));
+    sig->arity = arity;
+    sig->param_types = (Type*) arenaAlloc(&ctx->symbols.pool, (arity ? arity : 1) * sizeof(Type));
+    sig->return_type = returnType;
+    sig->declaration = NULL;
+    sig->subroutine = 0;
+    return sig;
+}
+
+// Auxiliar function for building the signature of a subroutine
+static Signature *signatureOf(SubRotDeclaration *s, VarDeclaration *params, Type returnType, SemanticContext *ctx) {
+    int arity = 0;
+    for (VarDeclaration *p = params; p; p = p->next) arity++;
+
+    Signature *sig = newSignature(arity, returnType, ctx);
+    int i = 0;
+    for (VarDeclaration *p = params; p; p = p->next) sig->param_types[i++] = varTypeToType(p->type);
+    sig->declaration = s;
+    return sig;
+}
+
+// Subroutine pre-declaration: installs every subroutine with its signature
+static void predeclareSubroutines(SubRotDeclaration *list, SemanticContext *ctx) {
     SubRotDeclaration *s = list;
 
     while (s != NULL) {
         if (s->type == Proc) {
-            install(s->subrotU.procInfo.identifier, CAT_PROCEDURE, TYPE_VOID, current_scope->level);
+            Symbol *sym = declare(s->subrotU.procInfo.identifier, CAT_PROCEDURE, TYPE_VOID, ctx);
+            sym->signature = signatureOf(s, s->subrotU.procInfo.formParams, TYPE_VOID, ctx);
 
         } else {
-            install(s->subrotU.funcInfo.identifier, CAT_FUNCTION, varTypeToType(s->subrotU.funcInfo.returnType), current_scope->level);
+            Type ret_type = varTypeToType(s->subrotU.funcInfo.returnType);
+            Symbol *sym = declare(s->subrotU.funcInfo.identifier, CAT_FUNCTION, ret_type, ctx);
+            sym->signature = signatureOf(s, s->subrotU.funcInfo.formParams, ret_type, ctx);
         }
 
         s = s->next;
@@ -116,33 +242,33 @@ static void predeclareSubroutines(SubRotDeclaration *list) {
 
 
 // Check all subroutines
-static void checkSubroutines(SubRotDeclaration *list) {
+static void checkSubroutines(SubRotDeclaration *list, SemanticContext *ctx) {
     while (list) {
-        checkSubroutine(list);
+        checkSubroutine(list, ctx);
         list = list->next;
     }
 }
 
 
 // Individual subroutine
-static void checkSubroutine(SubRotDeclaration *srd) {
+static void checkSubroutine(SubRotDeclaration *srd, SemanticContext *ctx) {
     if (srd->type == Proc) {
         VarDeclaration *params = srd->subrotU.procInfo.formParams;
         SubRotBlock *body = srd->subrotU.procInfo.subRotBlock;
 
-        enter_scope();
+        enter_scope(&ctx->symbols);
 
         // Parameters
-        checkVarDeclarations(params, 1);
+        checkVarDeclarations(params, 1, ctx);
 
         // Local variables
-        if (body) checkVarDeclarations(body->varDeclarations, 0);
+        if (body) checkVarDeclarations(body->varDeclarations, 0, ctx);
 
         // Commands
         int dummy_ret = 0;
-        checkSubroutineBlock(body, NULL, 0, &dummy_ret);
+        checkSubroutineBlock(body, NULL, 0, &dummy_ret, ctx);
 
-        leave_scope();
+        leave_scope(&ctx->symbols);
 
     } else {
         char *name = srd->subrotU.funcInfo.identifier;
@@ -150,75 +276,81 @@ static void checkSubroutine(SubRotDeclaration *srd) {
         SubRotBlock *body = srd->subrotU.funcInfo.subRotBlock;
         Type ret_type = varTypeToType(srd->subrotU.funcInfo.returnType);
 
-        enter_scope();
+        enter_scope(&ctx->symbols);
 
-        // Implicit return variable
-        install(name, CAT_VAR, ret_type, current_scope->level);
+        // Implicit return variable: the slot reserved below the parameters,
+        // so it takes no local offset
+        Symbol *ret = declare(name, CAT_VAR, ret_type, ctx);
 
         // Parameters
-        checkVarDeclarations(params, 1);
+        checkVarDeclarations(params, 1, ctx);
+
+        int n_params = 0;
+        for (VarDeclaration *p = params; p; p = p->next) n_params++;
+        ret->offset = -(5 + n_params);
+        ctx->symbols.current_scope->next_offset--;
 
         // local variables
-        if (body) checkVarDeclarations(body->varDeclarations, 0);
+        if (body) checkVarDeclarations(body->varDeclarations, 0, ctx);
 
         // Commands
         int return_count = 0;
-        checkSubroutineBlock(body, name, 1, &return_count);
+        checkSubroutineBlock(body, name, 1, &return_count, ctx);
 
-        leave_scope();
+        leave_scope(&ctx->symbols);
 
         if (return_count == 0)
-            semanticError("function without return.\n");
+            semanticError(ctx, "function without return.");
         if (return_count > 1)
-            semanticError("function has more than one return.\n");
+            semanticError(ctx, "function has more than one return.");
     }
 }
 
 
 // Subroutine block
-static void checkSubroutineBlock(SubRotBlock *srb, const char *funcName, int isFunction, int *returnCount) {
+static void checkSubroutineBlock(SubRotBlock *srb, const char *funcName, int isFunction, int *returnCount, SemanticContext *ctx) {
     if (!srb) return;
 
-    checkCommandList(srb->commands, funcName, returnCount);
+    checkCommandList(srb->commands, funcName, returnCount, ctx);
 }
 
 
 // Command list
-static void checkCommandList(Command *list, const char *currentFuncName, int *returnCount) {
+static void checkCommandList(Command *list, const char *currentFuncName, int *returnCount, SemanticContext *ctx) {
     while (list) {
-        checkCommand(list, currentFuncName, returnCount);
+        checkCommand(list, currentFuncName, returnCount, ctx);
         list = list->next;
     }
 }
 
 
 // Individual command
-static void checkCommand(Command *cmd, const char *currentFuncName, int *returnCount) {
+static void checkCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx) {
     if (!cmd) return;
 
     switch (cmd->type) {
         case Assign:
-            checkAssignCommand(cmd, currentFuncName, returnCount);
+            checkAssignCommand(cmd, currentFuncName, returnCount, ctx);
             break;
 
         case ProcCall:
-            checkProcCallCommand(cmd);
+            checkProcCallCommand(cmd, ctx);
             break;
 
         case Conditional:
-            checkConditionalCommand(cmd, currentFuncName, returnCount);
+            checkConditionalCommand(cmd, currentFuncName, returnCount, ctx);
             break;
 
         case Loop:
-            checkLoopCommand(cmd, currentFuncName, returnCount);
+            checkLoopCommand(cmd, currentFuncName, returnCount, ctx);
             break;
 
         case Read:
-            checkReadCommand(cmd);
+            checkReadCommand(cmd, ctx);
             break;
 
         case Write:
-            checkWriteCommand(cmd);
+            checkWriteCommand(cmd, ctx);
             break;
 
         default:
@@ -228,74 +360,58 @@ static void checkCommand(Command *cmd, const char *currentFuncName, int *returnC
 
 
 // Assignment
-static void checkAssignCommand(Command *cmd, const char *currentFuncName, int *returnCount) {
+static void checkAssignCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx) {
     char *id = cmd->cmdU.assignInfo.identifier;
     Expression *expr = cmd->cmdU.assignInfo.expression;
 
-    Symbol *sym = lookup(id);
-    if (!sym) semanticError("assignment for undeclared identifier.\n");
-
-    if (sym->category != CAT_VAR && sym->category != CAT_PARAM)
-        semanticError("left side of the assignment must be a variable or parameter.\n");
+    Symbol *sym = assignedSymbol(id, ctx);
+    cmd->cmdU.assignInfo.binding = bindingOf(sym);
 
     Type lhs = sym->type;
-    Type rhs = checkExpression(expr);
+    Type rhs = checkExpression(expr, ctx);
 
     if (lhs != rhs)
-        semanticError("incompatible types in assignment.\n");
+        semanticError(ctx, "incompatible types in assignment.");
 
     // Count returns for functions
-    if (currentFuncName && strcmp(id, currentFuncName) == 0) {
+    if (currentFuncName && id == currentFuncName) {
         (*returnCount)++;
     }
 }
 
 
 // Procedure Call
-static void checkProcCallCommand(Command *cmd) {
+static void checkProcCallCommand(Command *cmd, SemanticContext *ctx) {
     char *name = cmd->cmdU.procCallInfo.identifier;
     Expression *args = cmd->cmdU.procCallInfo.expressionList;
 
-    Symbol *sym = lookup(name);
-    if (!sym) semanticError("not declared procedure call.\n");
+    Signature *sig = procedureSignature(name, ctx);
+    cmd->cmdU.procCallInfo.target = sig->declaration;
 
-    if (sym->category != CAT_PROCEDURE)
-        semanticError("identifier called as a procedure is not a procedure.\n");
-
-    // Search declaration in AST
-    SubRotDeclaration *s = globalSubrotList;
-    while (s) {
-        if (s->type == Proc && strcmp(s->subrotU.procInfo.identifier, name) == 0)
-            break;
-        s = s->next;
-    }
-
-    if (!s) semanticError("declaration of the procedure was not found.\n");
-
-    checkExpressionList(args, s->subrotU.procInfo.formParams);
+    checkExpressionList(args, sig, ctx);
 }
 
 
 // Conditional
-static void checkConditionalCommand(Command *cmd, const char *currentFuncName, int *returnCount) {
+static void checkConditionalCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx) {
     Expression *cond = cmd->cmdU.condInfo.condExpression;
 
     // Condition must be boolean
-    if (checkExpression(cond) != TYPE_BOOL)
-        semanticError("IF's conditional expression must result in a boolean result.\n");
+    if (checkExpression(cond, ctx) != TYPE_BOOL)
+        semanticError(ctx, "IF's conditional expression must result in a boolean result.");
 
     // Measure returns separately in each branch
     int before = *returnCount;
 
     // If branch
-    checkCommandList(cmd->cmdU.condInfo.cmdIf, currentFuncName, returnCount);
+    checkCommandList(cmd->cmdU.condInfo.cmdIf, currentFuncName, returnCount, ctx);
     int if_returns = (*returnCount > before);
 
     // Else branch
     int else_returns = 0;
     if (cmd->cmdU.condInfo.cmdElse) {
         int before2 = *returnCount;
-        checkCommandList(cmd->cmdU.condInfo.cmdElse, currentFuncName, returnCount);
+        checkCommandList(cmd->cmdU.condInfo.cmdElse, currentFuncName, returnCount, ctx);
         else_returns = (*returnCount > before2);
     }
 
@@ -307,26 +423,21 @@ static void checkConditionalCommand(Command *cmd, const char *currentFuncName, i
 
 
 // While
-static void checkLoopCommand(Command *cmd, const char *currentFuncName, int *returnCount) {
-    if (checkExpression(cmd->cmdU.loopInfo.loopExpression) != TYPE_BOOL)
-        semanticError("WHILE's conditional expression must result in a boolean result.\n");
+static void checkLoopCommand(Command *cmd, const char *currentFuncName, int *returnCount, SemanticContext *ctx) {
+    if (checkExpression(cmd->cmdU.loopInfo.loopExpression, ctx) != TYPE_BOOL)
+        semanticError(ctx, "WHILE's conditional expression must result in a boolean result.");
 
-    checkCommandList(cmd->cmdU.loopInfo.cmdLoop, currentFuncName, returnCount);
+    checkCommandList(cmd->cmdU.loopInfo.cmdLoop, currentFuncName, returnCount, ctx);
 }
 
 
 // Read
-static void checkReadCommand(Command *cmd) {
+static void checkReadCommand(Command *cmd, SemanticContext *ctx) {
     IdentifierList *id = cmd->cmdU.readInfo.identifiers;
 
     while (id) {
-        Symbol *sym = lookup(id->identifier);
-
-        if (!sym)
-            semanticError("read identifier was not declared.\n");
-
-        if (sym->category != CAT_VAR && sym->category != CAT_PARAM)
-            semanticError("argument of READ must be a variable or a parameter.\n");
+        Symbol *sym = readSymbol(id->identifier, ctx);
+        id->binding = bindingOf(sym);
 
         id = id->next;
     }
@@ -334,47 +445,47 @@ static void checkReadCommand(Command *cmd) {
 
 
 // Write
-static void checkWriteCommand(Command *cmd) {
+static void checkWriteCommand(Command *cmd, SemanticContext *ctx) {
     Expression *e = cmd->cmdU.writeInfo.expressionList;
 
     while (e) {
-        checkExpression(e);
+        checkExpression(e, ctx);
         e = e->next;
     }
 }
 
 
 // EXPRESSÕES E PARÂMETROS
-static void checkExpressionList(Expression *list, VarDeclaration *formals) {
+static void checkExpressionList(Expression *list, const Signature *sig, SemanticContext *ctx) {
     Expression *arg = list;
-    VarDeclaration *param = formals;
+    int i = 0;
 
-    while (arg && param) {
-        if (checkExpression(arg) != varTypeToType(param->type))
-            semanticError("argument type does not match the parameter.\n");
+    while (arg && i < sig->arity) {
+        if (checkExpression(arg, ctx) != sig->param_types[i])
+            semanticError(ctx, "argument type does not match the parameter.");
 
         arg = arg->next;
-        param = param->next;
+        i++;
     }
 
-    if (arg || param)
-        semanticError("number of arguments does not match the number of parameters.\n");
+    if (arg || i < sig->arity)
+        semanticError(ctx, "number of arguments does not match the number of parameters.");
 }
 
 
 // Generic expression
-static Type checkExpression(Expression *e) {
-    if (!e) semanticError("null expression.\n");
+static Type checkExpression(Expression *e, SemanticContext *ctx) {
+    if (!e) semanticError(ctx, "null expression.");
 
     switch (e->type) {
-        case Binary:   return checkBinaryExpression(e);
-        case Unary:    return checkUnaryExpression(e);
-        case Var:      return checkVariableExpression(e);
+        case Binary:   return checkBinaryExpression(e, ctx);
+        case Unary:    return checkUnaryExpression(e, ctx);
+        case Var:      return checkVariableExpression(e, ctx);
         case ConstInt: return TYPE_INT;
         case ConstBool:return TYPE_BOOL;
-        case FuncCall: return checkFunctionCallExpression(e);
+        case FuncCall: return checkFunctionCallExpression(e, ctx);
         default:
-            semanticError("unknown expression.\n");
+            semanticError(ctx, "unknown expression.");
     }
 
     return TYPE_UNKNOWN;
@@ -382,11 +493,14 @@ static Type checkExpression(Expression *e) {
 
 
 // Binary expression
-static Type checkBinaryExpression(Expression *e) {
-    Type lt = checkExpression(e->exprU.binExpr.left);
-    Type rt = checkExpression(e->exprU.binExpr.right);
-    Operator op = e->exprU.binExpr.operator;
+static Type checkBinaryExpression(Expression *e, SemanticContext *ctx) {
+    Type lt = checkExpression(e->exprU.binExpr.left, ctx);
+    Type rt = checkExpression(e->exprU.binExpr.right, ctx);
+    return binaryType(e->operator, lt, rt, ctx);
+}
 
+// Type of an operation on operands of types lt and rt
+static Type binaryType(Operator op, Type lt, Type rt, SemanticContext *ctx) {
     switch (op) {
 
         case Plus:
@@ -394,7 +508,7 @@ static Type checkBinaryExpression(Expression *e) {
         case Multiplication:
         case Division:
             if (lt != TYPE_INT || rt != TYPE_INT)
-                semanticError("arithmetic operations require integers.\n");
+                semanticError(ctx, "arithmetic operations require integers.");
             return TYPE_INT;
 
         case Less:
@@ -402,23 +516,23 @@ static Type checkBinaryExpression(Expression *e) {
         case Greater:
         case GreaterEqual:
             if (lt != TYPE_INT || rt != TYPE_INT)
-                semanticError("relational operations require integers.\n");
+                semanticError(ctx, "relational operations require integers.");
             return TYPE_BOOL;
 
         case Equal:
         case Different:
             if (lt != rt)
-                semanticError("comparison operations require identical types.\n");
+                semanticError(ctx, "comparison operations require identical types.");
             return TYPE_BOOL;
 
         case And:
         case Or:
             if (lt != TYPE_BOOL || rt != TYPE_BOOL)
-                semanticError("logical operations require booleans.\n");
+                semanticError(ctx, "logical operations require booleans.");
             return TYPE_BOOL;
 
         default:
-            semanticError("invalid binary operator.\n");
+            semanticError(ctx, "invalid binary operator.");
     }
 
     return TYPE_UNKNOWN;
@@ -426,61 +540,327 @@ static Type checkBinaryExpression(Expression *e) {
 
 
 // Unary expression
-static Type checkUnaryExpression(Expression *e) {
-
-    Operator op = e->exprU.unyExpr.operator;
-    Type rt = checkExpression(e->exprU.unyExpr.right);
+static Type checkUnaryExpression(Expression *e, SemanticContext *ctx) {
+    Type rt = checkExpression(e->exprU.unyExpr.right, ctx);
+    return unaryType(e->operator, rt, ctx);
+}
 
+static Type unaryType(Operator op, Type rt, SemanticContext *ctx) {
     if (op == Not) {
         if (rt != TYPE_BOOL)
-            semanticError("NOT operation requires boolean.\n");
+            semanticError(ctx, "NOT operation requires boolean.");
         return TYPE_BOOL;
     }
 
     if (op == Minus) {
         if (rt != TYPE_INT)
-            semanticError("MINUS operation requires integer.\n");
+            semanticError(ctx, "MINUS operation requires integer.");
         return TYPE_INT;
     }
 
-    semanticError("invalid unary operator.\n");
+    semanticError(ctx, "invalid unary operator.");
     return TYPE_UNKNOWN;
 }
 
 
 // Variable expression
-static Type checkVariableExpression(Expression *e) {
-    Symbol *sym = lookup(e->exprU.varExpr.identifier);
-    if (!sym) semanticError("use of not declared variable.\n");
-
-    if (sym->category != CAT_VAR && sym->category != CAT_PARAM)
-        semanticError("only variables or parameters can appear in expressions.\n");
-
+static Type checkVariableExpression(Expression *e, SemanticContext *ctx) {
+    Symbol *sym = variableSymbol(e->exprU.varExpr.identifier, ctx);
+    e->exprU.varExpr.binding = bindingOf(sym);
+    e->exprU.varExpr.valueType = sym->type == TYPE_BOOL ? Bool : Int;
     return sym->type;
 }
 
 // Function call
-static Type checkFunctionCallExpression(Expression *e) {
+static Type checkFunctionCallExpression(Expression *e, SemanticContext *ctx) {
     char *name = e->exprU.funCallExpr.identifier;
     Expression *args = e->exprU.funCallExpr.expressionList;
 
-    Symbol *sym = lookup(name);
-    if (!sym) semanticError("not declared function call.\n");
+    Signature *sig = functionSignature(name, ctx);
+    e->exprU.funCallExpr.target = sig->declaration;
 
-    if (sym->category != CAT_FUNCTION)
-        semanticError("identifier called as a function is not a function.\n");
+    checkExpressionList(args, sig, ctx);
 
-    // Search function in AST to get parameters
-    SubRotDeclaration *s = globalSubrotList;
-    while (s) {
-        if (s->type == Func && strcmp(s->subrotU.funcInfo.identifier, name) == 0)
-            break;
-        s = s->next;
+    return sig->return_type;
+}
+
+
+// Purity: a subroutine is pure when calling it can neither have an
+// effect nor fail, so a call whose result is not needed may be skipped.
+// That rules out input/output, assignments to globals, division (by
+// zero), loops and recursion (they may not end) and impure calls
+enum { PURITY_UNKNOWN = -2, PURITY_VISITING = -1 };
+
+static int settlePurity(SubRotDeclaration *sd);
+
+static int isPureExpressionList(const Expression *list) {
+    for (; list; list = list->next)
+        if (!isPureExpression(list)) return 0;
+    return 1;
+}
+
+int isPureExpression(const Expression *e) {
+    switch (e->type) {
+        case Binary:
+            return e->operator != Division && isPureExpression(e->exprU.binExpr.left) && isPureExpression(e->exprU.binExpr.right);
+        case Unary:
+            return isPureExpression(e->exprU.unyExpr.right);
+        case FuncCall:
+            return settlePurity(e->exprU.funCallExpr.target) && isPureExpressionList(e->exprU.funCallExpr.expressionList);
+        default:
+            return 1;
     }
+}
 
-    if (!s) semanticError("function was not found.\n");
+static int isPureCommandList(const Command *c) {
+    for (; c; c = c->next) {
+        switch (c->type) {
+            case Assign:
+                // Level 0 holds the globals
+                if (c->cmdU.assignInfo.binding.level == 0 || !isPureExpression(c->cmdU.assignInfo.expression)) return 0;
+                break;
+            case ProcCall:
+                if (!settlePurity(c->cmdU.procCallInfo.target) || !isPureExpressionList(c->cmdU.procCallInfo.expressionList)) return 0;
+                break;
+            case Conditional:
+                if (!isPureExpression(c->cmdU.condInfo.condExpression) ||
+                    !isPureCommandList(c->cmdU.condInfo.cmdIf) || !isPureCommandList(c->cmdU.condInfo.cmdElse)) return 0;
+                break;
+            default:
+                return 0;
+        }
+    }
+    return 1;
+}
 
-    checkExpressionList(args, s->subrotU.funcInfo.formParams);
+// Settles a subroutine after the ones it calls; reaching one still being
+// visited means the call is recursive
+static int settlePurity(SubRotDeclaration *sd) {
+    if (sd->pure == PURITY_VISITING) return 0;
+    if (sd->pure == PURITY_UNKNOWN) {
+        sd->pure = PURITY_VISITING;
+        SubRotBlock *body = sd->type == Proc ? sd->subrotU.procInfo.subRotBlock : sd->subrotU.funcInfo.subRotBlock;
+        sd->pure = body ? isPureCommandList(body->commands) : 1;
+    }
+    return sd->pure;
+}
 
-    return sym->type;
+static void markPureSubroutines(SubRotDeclaration *list) {
+    for (SubRotDeclaration *sd = list; sd; sd = sd->next) sd->pure = PURITY_UNKNOWN;
+    for (SubRotDeclaration *sd = list; sd; sd = sd->next) settlePurity(sd);
+}
+
+
+// - Flat Layout --------------------------
+
+// The same checks over the rows of comp->flat, binding every name in
+// place. Purity is not marked: only the optimizations read it
+
+static void checkFlatCommands(FlatAst *ast, FlatIndex c, const char *currentFuncName, int *returnCount, SemanticContext *ctx);
+static Type checkFlatExpression(FlatAst *ast, FlatIndex e, SemanticContext *ctx);
+
+static char *flatName(uint32_t name, SemanticContext *ctx) {
+    return ctx->comp->identifiers.names[name];
+}
+
+static int countFlatVariables(const FlatAst *ast, FlatIndex v) {
+    int n = 0;
+    for (; v; v = ast->variables[v].next) n++;
+    return n;
+}
+
+static void checkFlatVariables(FlatAst *ast, FlatIndex v, int asParams, SemanticContext *ctx) {
+    for (int i = 0; v; v = ast->variables[v].next, i++) {
+        Symbol *sym = declare(flatName(ast->variables[v].name, ctx),
+                              asParams ? CAT_PARAM : CAT_VAR,
+                              varTypeToType(ast->variables[v].type), ctx);
+        if (asParams) sym->offset = -5 - i;
+    }
+}
+
+static void predeclareFlatSubroutines(FlatAst *ast, SemanticContext *ctx) {
+    for (FlatIndex s = ast->subroutineList; s; s = ast->subroutines[s].next) {
+        FlatSubroutine *sub = &ast->subroutines[s];
+        Type ret_type = sub->kind == Proc ? TYPE_VOID : varTypeToType(sub->returnType);
+        Symbol *sym = declare(flatName(sub->name, ctx), sub->kind == Proc ? CAT_PROCEDURE : CAT_FUNCTION, ret_type, ctx);
+
+        sym->signature = newSignature(countFlatVariables(ast, sub->params), ret_type, ctx);
+        int i = 0;
+        for (FlatIndex v = sub->params; v; v = ast->variables[v].next)
+            sym->signature->param_types[i++] = varTypeToType(ast->variables[v].type);
+        sym->signature->subroutine = s;
+    }
+}
+
+static void checkFlatSubroutine(FlatAst *ast, FlatSubroutine *sub, SemanticContext *ctx) {
+    enter_scope(&ctx->symbols);
+
+    if (sub->kind == Proc) {
+        checkFlatVariables(ast, sub->params, 1, ctx);
+        checkFlatVariables(ast, sub->locals, 0, ctx);
+
+        int dummy_ret = 0;
+        checkFlatCommands(ast, sub->commands, NULL, &dummy_ret, ctx);
+        leave_scope(&ctx->symbols);
+        return;
+    }
+
+    // Implicit return variable, below the parameters
+    char *name = flatName(sub->name, ctx);
+    Symbol *ret = declare(name, CAT_VAR, varTypeToType(sub->returnType), ctx);
+
+    checkFlatVariables(ast, sub->params, 1, ctx);
+    ret->offset = -(5 + countFlatVariables(ast, sub->params));
+    ctx->symbols.current_scope->next_offset--;
+
+    checkFlatVariables(ast, sub->locals, 0, ctx);
+
+    int return_count = 0;
+    checkFlatCommands(ast, sub->commands, name, &return_count, ctx);
+
+    leave_scope(&ctx->symbols);
+
+    if (return_count == 0)
+        semanticError(ctx, "function without return.");
+    if (return_count > 1)
+        semanticError(ctx, "function has more than one return.");
+}
+
+static void checkFlatProgram(FlatAst *ast, SemanticContext *ctx) {
+    declare(flatName(ast->name, ctx), CAT_PROGRAM, TYPE_VOID, ctx);
+
+    checkFlatVariables(ast, ast->globals, 0, ctx);
+    predeclareFlatSubroutines(ast, ctx);
+
+    for (FlatIndex s = ast->subroutineList; s; s = ast->subroutines[s].next)
+        checkFlatSubroutine(ast, &ast->subroutines[s], ctx);
+
+    int dummy_return = 0;
+    checkFlatCommands(ast, ast->commandList, NULL, &dummy_return, ctx);
+}
+
+static void checkFlatArguments(FlatAst *ast, FlatIndex arg, const Signature *sig, SemanticContext *ctx) {
+    int i = 0;
+
+    while (arg && i < sig->arity) {
+        if (checkFlatExpression(ast, arg, ctx) != sig->param_types[i])
+            semanticError(ctx, "argument type does not match the parameter.");
+
+        arg = ast->expressions.next[arg];
+        i++;
+    }
+
+    if (arg || i < sig->arity)
+        semanticError(ctx, "number of arguments does not match the number of parameters.");
+}
+
+static void checkFlatCommands(FlatAst *ast, FlatIndex c, const char *currentFuncName, int *returnCount, SemanticContext *ctx) {
+    FlatCommands *t = &ast->commands;
+
+    for (; c; c = t->next[c]) {
+        switch (t->kind[c]) {
+            case Assign: {
+                char *id = flatName(t->a[c], ctx);
+                Symbol *sym = assignedSymbol(id, ctx);
+                t->level[c] = (uint8_t) sym->level;
+                t->c[c] = (FlatIndex) sym->offset;
+
+                if (sym->type != checkFlatExpression(ast, t->b[c], ctx))
+                    semanticError(ctx, "incompatible types in assignment.");
+
+                if (currentFuncName && id == currentFuncName) (*returnCount)++;
+                break;
+            }
+
+            case ProcCall: {
+                Signature *sig = procedureSignature(flatName(t->a[c], ctx), ctx);
+                t->a[c] = sig->subroutine;
+                checkFlatArguments(ast, t->b[c], sig, ctx);
+                break;
+            }
+
+            case Conditional: {
+                if (checkFlatExpression(ast, t->a[c], ctx) != TYPE_BOOL)
+                    semanticError(ctx, "IF's conditional expression must result in a boolean result.");
+
+                int before = *returnCount;
+                checkFlatCommands(ast, t->b[c], currentFuncName, returnCount, ctx);
+                int if_returns = (*returnCount > before);
+
+                int else_returns = 0;
+                if (t->c[c]) {
+                    int before2 = *returnCount;
+                    checkFlatCommands(ast, t->c[c], currentFuncName, returnCount, ctx);
+                    else_returns = (*returnCount > before2);
+                }
+
+                if (currentFuncName && if_returns && else_returns) (*returnCount) = before + 1;
+                break;
+            }
+
+            case Loop:
+                if (checkFlatExpression(ast, t->a[c], ctx) != TYPE_BOOL)
+                    semanticError(ctx, "WHILE's conditional expression must result in a boolean result.");
+
+                checkFlatCommands(ast, t->b[c], currentFuncName, returnCount, ctx);
+                break;
+
+            case Read:
+                for (FlatIndex e = t->a[c]; e; e = ast->expressions.next[e]) {
+                    Symbol *sym = readSymbol(flatName(ast->expressions.lhs[e], ctx), ctx);
+                    ast->expressions.op[e] = (uint8_t) sym->level;
+                    ast->expressions.rhs[e] = (FlatIndex) sym->offset;
+                }
+                break;
+
+            case Write:
+                for (FlatIndex e = t->a[c]; e; e = ast->expressions.next[e])
+                    checkFlatExpression(ast, e, ctx);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+static Type checkFlatExpression(FlatAst *ast, FlatIndex e, SemanticContext *ctx) {
+    if (!e) semanticError(ctx, "null expression.");
+
+    FlatExpressions *t = &ast->expressions;
+    switch (t->kind[e]) {
+        case Binary: {
+            Type lt = checkFlatExpression(ast, t->lhs[e], ctx);
+            Type rt = checkFlatExpression(ast, t->rhs[e], ctx);
+            return binaryType((Operator) t->op[e], lt, rt, ctx);
+        }
+
+        case Unary:
+            return unaryType((Operator) t->op[e], checkFlatExpression(ast, t->rhs[e], ctx), ctx);
+
+        case Var: {
+            Symbol *sym = variableSymbol(flatName(t->lhs[e], ctx), ctx);
+            t->op[e] = (uint8_t) sym->level;
+            t->rhs[e] = (FlatIndex) sym->offset;
+            return sym->type;
+        }
+
+        case ConstInt:
+            return TYPE_INT;
+
+        case ConstBool:
+            return TYPE_BOOL;
+
+        case FuncCall: {
+            Signature *sig = functionSignature(flatName(t->rhs[e], ctx), ctx);
+            t->rhs[e] = sig->subroutine;
+            checkFlatArguments(ast, t->lhs[e], sig, ctx);
+            return sig->return_type;
+        }
+
+        default:
+            semanticError(ctx, "unknown expression.");
+    }
+
+    return TYPE_UNKNOWN;
 }
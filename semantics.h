@@ -1,10 +1,16 @@
 #ifndef SEMANTICS_H
 #define SEMANTICS_H
 
-#include "rascal_ast.h"
+#include "compilation.h"
 #include "symbol_table.h"
 
-// Executes semantic analysis
-void semanticCheck(Program *program);
+// Executes semantic analysis, annotating the AST with the bindings,
+// value types and call targets code generation uses
+int semanticCheck(Compilation *comp);
+
+// Whether evaluating an expression of a checked program can neither
+// have an effect nor fail: no division and only pure calls (see the
+// pure flag of SubRotDeclaration)
+int isPureExpression(const Expression *e);
 
 #endif
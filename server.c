@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "server.h"
+#include "rascal.h"
+#include "compilation.h"
+#include "rascal_inline.h"
+
+#define MAX_REQUEST_SIZE (16 * 1024 * 1024)
+#define LATENCY_SAMPLES 8192
+
+// State shared by the worker threads
+typedef struct Server {
+    int listenFd;
+    int optimize;               // Level every request is compiled at
+    int inlineLimit;            // Largest subroutine body inlined at -O2
+    volatile sig_atomic_t stopping;
+
+    // Latency of the most recent requests, in microseconds
+    double samples[LATENCY_SAMPLES];
+    long requests;
+    long failed;
+    pthread_mutex_t lock;       // Guards samples, requests and failed
+} Server;
+
+// One worker: a warm compiler and a request buffer kept between requests
+typedef struct ServerWorker {
+    Server *server;
+    RascalCompiler *compiler;
+    char *request;
+    size_t capacity;
+} ServerWorker;
+
+// Reads the whole request: returns its length or -1 on error
+static long readRequest(int fd, ServerWorker *w) {
+    size_t length = 0;
+
+    for (;;) {
+        if (length == w->capacity) {
+            if (w->capacity >= MAX_REQUEST_SIZE) return -1;
+            size_t capacity = w->capacity ? w->capacity * 2 : 64 * 1024;
+            char *request = (char *) realloc(w->request, capacity);
+            if (!request) return -1;
+            w->request = request;
+            w->capacity = capacity;
+        }
+
+        ssize_t n = read(fd, w->request + length, w->capacity - length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -1;
+        if (n == 0) return (long) length;
+        length += n;
+    }
+}
+
+// Writes all bytes, without dying if the client went away
+static int writeAll(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        data += n;
+        length -= n;
+    }
+    return 1;
+}
+
+// Sends the reply for one compilation
+static int writeReply(int fd, const RascalResult *result) {
+    char *header = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&header, &size);
+    if (!out) return 0;
+
+    fprintf(out, "status %d\n", result->status);
+    for (int i = 0; i < result->diagnosticCount; i++) {
+        const RascalDiagnostic *d = &result->diagnostics[i];
+        fprintf(out, "diagnostic %d %d ", d->phase, d->line);
+        for (const char *c = d->message; *c; c++)
+            fputc(*c == '\n' ? ' ' : *c, out);
+        fputc('\n', out);
+    }
+    fprintf(out, "mepa %zu\n", result->mepaLength);
+    fclose(out);
+
+    int ok = writeAll(fd, header, size) && writeAll(fd, result->mepa, result->mepaLength);
+    free(header);
+    return ok;
+}
+
+// Records the latency of a finished request
+static void recordLatency(Server *server, double micros, int failed) {
+    pthread_mutex_lock(&server->lock);
+    server->samples[server->requests % LATENCY_SAMPLES] = micros;
+    server->requests++;
+    if (failed) server->failed++;
+    pthread_mutex_unlock(&server->lock);
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+// Prints the latency percentiles of the recent requests
+static void printLatency(Server *server) {
+    static double sorted[LATENCY_SAMPLES];
+
+    pthread_mutex_lock(&server->lock);
+    long requests = server->requests, failed = server->failed;
+    int count = requests < LATENCY_SAMPLES ? (int) requests : LATENCY_SAMPLES;
+    memcpy(sorted, server->samples, count * sizeof(double));
+    pthread_mutex_unlock(&server->lock);
+
+    if (count == 0) {
+        printf("Serve: no requests\n");
+    } else {
+        qsort(sorted, count, sizeof(double), compareDoubles);
+        printf("Serve: %ld requests, %ld failed, latency over last %d (us): "
+               "p50 %.0f, p90 %.0f, p99 %.0f, max %.0f\n",
+            requests, failed, count,
+            sorted[(count - 1) * 50 / 100], sorted[(count - 1) * 90 / 100],
+            sorted[(count - 1) * 99 / 100], sorted[count - 1]);
+    }
+    fflush(stdout);
+}
+
+// Worker thread: accepts connections until the server stops
+static void *serveWorker(void *arg) {
+    ServerWorker *w = (ServerWorker *) arg;
+    Server *server = w->server;
+
+    while (!server->stopping) {
+        int fd = accept(server->listenFd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        int failed = 1;
+        long length = readRequest(fd, w);
+        if (length >= 0) {
+            RascalOptions options = {NULL, server->optimize, server->inlineLimit};
+            RascalResult result;
+            rascal_compiler_compile(w->compiler, w->request, (size_t) length, &options, &result);
+            writeReply(fd, &result);
+            failed = result.status != 0;
+            rascal_free_result(&result);
+        } else {
+            static const char tooLarge[] = "status 1\ndiagnostic 0 0 Request could not be read\nmepa 0\n";
+            writeAll(fd, tooLarge, sizeof(tooLarge) - 1);
+        }
+        close(fd);
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        recordLatency(server, (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3, failed);
+    }
+
+    return NULL;
+}
+
+// Opens the listening socket, replacing a stale one
+static int listenOn(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(fd, 128) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Server mode entry point (argv[0] is "--serve")
+int serveMain(int argc, char *argv[]) {
+    const char *path = NULL;
+    int workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int optimize = 0;
+    int inlineLimit = INLINE_LIMIT_DEFAULT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (parseOptimizeOption(argv[i]) >= 0) {
+            optimize = parseOptimizeOption(argv[i]);
+        } else if (strcmp(argv[i], "--inline-limit") == 0 && i + 1 < argc) {
+            inlineLimit = parseInlineLimit(argv[++i]);
+            if (inlineLimit < 0) {
+                fprintf(stderr, "\nInvalid inline limit: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "\nUnknown option: %s\n", argv[i]);
+            path = NULL;
+            break;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (!path) {
+        fprintf(stderr, "\nUsage: rascalc --serve [-j <workers>] [-O<level>] [--inline-limit <nodes>] <socket_path>\n");
+        return 1;
+    }
+    if (workers < 1) workers = 1;
+
+    // Signals are taken by sigwait below, never by the workers
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    static Server server;
+    server.listenFd = listenOn(path);
+    if (server.listenFd < 0) {
+        fprintf(stderr, "\nError listening on socket: %s\n", path);
+        return 1;
+    }
+    server.stopping = 0;
+    server.optimize = optimize;
+    server.inlineLimit = inlineLimit;
+    server.requests = 0;
+    server.failed = 0;
+    pthread_mutex_init(&server.lock, NULL);
+
+    ServerWorker *pool = (ServerWorker *) calloc(workers, sizeof(ServerWorker));
+    pthread_t *threads = (pthread_t *) malloc(workers * sizeof(pthread_t));
+    for (int i = 0; i < workers; i++) {
+        pool[i].server = &server;
+        pool[i].compiler = rascal_compiler_new();
+        pthread_create(&threads[i], NULL, serveWorker, &pool[i]);
+    }
+
+    printf("Serving on %s (%d workers)\n", path, workers);
+    fflush(stdout);
+
+    for (;;) {
+        int sig;
+        sigwait(&signals, &sig);
+        printLatency(&server);
+        if (sig != SIGUSR1) break;
+    }
+
+    // Wakes the workers blocked in accept
+    server.stopping = 1;
+    shutdown(server.listenFd, SHUT_RDWR);
+    for (int i = 0; i < workers; i++) {
+        pthread_join(threads[i], NULL);
+        rascal_compiler_free(pool[i].compiler);
+        free(pool[i].request);
+    }
+
+    close(server.listenFd);
+    unlink(path);
+    pthread_mutex_destroy(&server.lock);
+    free(threads);
+    free(pool);
+
+    return 0;
+}
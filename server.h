@@ -0,0 +1,16 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// Server mode: compiles programs sent over a Unix domain socket
+//   rascalc --serve [-j <workers>] [-O<level>] [--inline-limit <nodes>] <socket_path>
+//
+// A request is the source text, ended by shutting down the writing
+// side of the connection. The reply is
+//   status <0|1>
+//   diagnostic <phase> <line> <message>     (one per diagnostic)
+//   mepa <length>
+// followed by <length> bytes of MEPA code.
+// SIGUSR1 prints the latency percentiles, SIGINT and SIGTERM stop the server
+int serveMain(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,95 @@
+#include <string.h>
+#include "sha256.h"
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+// Hashes one 64 byte block
+static void sha256Block(Sha256* h, const unsigned char* p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+        w[i] = (uint32_t) p[4 * i] << 24 | (uint32_t) p[4 * i + 1] << 16 | (uint32_t) p[4 * i + 2] << 8 | p[4 * i + 3];
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = h->state[0], b = h->state[1], c = h->state[2], d = h->state[3];
+    uint32_t e = h->state[4], f = h->state[5], g = h->state[6], k = h->state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = k + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    h->state[0] += a; h->state[1] += b; h->state[2] += c; h->state[3] += d;
+    h->state[4] += e; h->state[5] += f; h->state[6] += g; h->state[7] += k;
+}
+
+void sha256Init(Sha256* h) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(h->state, initial, sizeof(initial));
+    h->length = 0;
+    h->blockUsed = 0;
+}
+
+void sha256Update(Sha256* h, const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*) data;
+    h->length += length;
+
+    // Complete a partial block first
+    if (h->blockUsed > 0) {
+        size_t n = 64 - h->blockUsed;
+        if (n > length) n = length;
+        memcpy(h->block + h->blockUsed, p, n);
+        h->blockUsed += n;
+        p += n;
+        length -= n;
+        if (h->blockUsed < 64) return;
+        sha256Block(h, h->block);
+        h->blockUsed = 0;
+    }
+
+    for (; length >= 64; p += 64, length -= 64)
+        sha256Block(h, p);
+
+    memcpy(h->block, p, length);
+    h->blockUsed = length;
+}
+
+void sha256Final(Sha256* h, unsigned char digest[SHA256_DIGEST_SIZE]) {
+    uint64_t bits = h->length * 8;
+
+    // Padding: 0x80, zeros, then the length in bits, big endian
+    h->block[h->blockUsed++] = 0x80;
+    if (h->blockUsed > 56) {
+        memset(h->block + h->blockUsed, 0, 64 - h->blockUsed);
+        sha256Block(h, h->block);
+        h->blockUsed = 0;
+    }
+    memset(h->block + h->blockUsed, 0, 56 - h->blockUsed);
+    for (int i = 0; i < 8; i++)
+        h->block[56 + i] = (unsigned char) (bits >> (56 - 8 * i));
+    sha256Block(h, h->block);
+
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = (unsigned char) (h->state[i] >> 24);
+        digest[4 * i + 1] = (unsigned char) (h->state[i] >> 16);
+        digest[4 * i + 2] = (unsigned char) (h->state[i] >> 8);
+        digest[4 * i + 3] = (unsigned char) h->state[i];
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SHA256_DIGEST_SIZE 32
+
+// Incremental SHA-256 (FIPS 180-4)
+typedef struct Sha256 {
+    uint32_t state[8];
+    uint64_t length;            // Bytes hashed so far
+    unsigned char block[64];
+    size_t blockUsed;
+} Sha256;
+
+// Hash functions
+void sha256Init(Sha256* h);
+void sha256Update(Sha256* h, const void* data, size_t length);
+void sha256Final(Sha256* h, unsigned char digest[SHA256_DIGEST_SIZE]);
+
+#endif
@@ -1,101 +1,196 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "symbol_table.h"
 
-// Current scope of symbol table
-Scope *current_scope = NULL;
+#define INITIAL_CAPACITY 256
+
+// Names are interned, so they are hashed and compared by address.
+// Interned text is packed byte by byte: every address bit matters
+static unsigned hash_name(const char *name) {
+    uint64_t p = (uint64_t) (uintptr_t) name;
+    return (unsigned) ((p * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+// Doubles the slot array, rehashing the names
+static void grow_slots(SymbolTable *table) {
+    unsigned capacity = table->capacity ? table->capacity * 2 : INITIAL_CAPACITY;
+    SymbolSlot *slots = (SymbolSlot*) calloc(capacity, sizeof(SymbolSlot));
+
+    for (unsigned i = 0; i < table->capacity; i++) {
+        if (!table->slots[i].name) continue;
+        unsigned j = hash_name(table->slots[i].name) & (capacity - 1);
+        while (slots[j].name) j = (j + 1) & (capacity - 1);
+        slots[j] = table->slots[i];
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+}
+
+// Slot holding a name, or the empty slot where it would go.
+// The table must have slots; probes counts the slots looked at
+static SymbolSlot* probe_slot(SymbolTable *table, char *name, long *probes) {
+    unsigned mask = table->capacity - 1;
+    unsigned i = hash_name(name) & mask;
+
+    (*probes)++;
+    while (table->slots[i].name && table->slots[i].name != name) {
+        i = (i + 1) & mask;
+        (*probes)++;
+    }
+
+    return &table->slots[i];
+}
+
+// Innermost visible symbol of a name, NULL when none
+static Symbol* find_symbol(SymbolTable *table, char *name) {
+    if (!table->capacity) return NULL;
+
+    SymbolSlot *slot = probe_slot(table, name, &table->lookup_steps);
+    return slot->name ? slot->symbol : NULL;
+}
+
+// Starts a symbol table with no scope
+void init_symbol_table(SymbolTable *table) {
+    table->current_scope = NULL;
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+    table->undo = NULL;
+    table->undo_count = 0;
+    table->undo_capacity = 0;
+    initArena(&table->pool);
+    table->free_symbols = NULL;
+    table->free_scopes = NULL;
+    table->lookup_calls = 0;
+    table->lookup_steps = 0;
+    table->install_calls = 0;
+}
+
+// Releases the scopes still open and every symbol
+void free_symbol_table(SymbolTable *table) {
+    while (table->current_scope) leave_scope(table);
+
+    free(table->slots);
+    free(table->undo);
+    releaseArena(&table->pool);
+    table->slots = NULL;
+    table->undo = NULL;
+    table->capacity = table->count = 0;
+    table->undo_count = table->undo_capacity = 0;
+    table->free_symbols = NULL;
+    table->free_scopes = NULL;
+}
 
 // Creates a new scope
-void enter_scope() {
-    Scope *s = (Scope*) malloc(sizeof(Scope));
-    s->symbols = NULL;
-    s->parent = current_scope;
+void enter_scope(SymbolTable *table) {
+    Scope *s = table->free_scopes;
+    if (s)
+        table->free_scopes = s->parent;
+    else
+        s = (Scope*) arenaAlloc(&table->pool, sizeof(Scope));
+
+    s->parent = table->current_scope;
     s->next_offset = 0;
+    s->undo_mark = table->undo_count;
 
-    if (!current_scope)
+    if (!table->current_scope)
         s->level = 0;
     else
-        s->level = current_scope->level + 1;
+        s->level = table->current_scope->level + 1;
 
-    current_scope = s;
+    table->current_scope = s;
 }
 
-// Destroys the current scope of symbol table
-void leave_scope() {
-    if (!current_scope) return;
+// Destroys the current scope of symbol table, unbinding its symbols
+// (newest first, so outer symbols of the same name come back)
+void leave_scope(SymbolTable *table) {
+    if (!table->current_scope) return;
+
+    Scope *old = table->current_scope;
 
-    Scope *old = current_scope;
-    Symbol *sym = old->symbols;
+    while (table->undo_count > old->undo_mark) {
+        Symbol *sym = table->undo[--table->undo_count];
+        long probes = 0;
+        SymbolSlot *slot = probe_slot(table, sym->name, &probes);
+        slot->symbol = sym->shadowed;
 
-    while (sym) {
-        Symbol *next = sym->next;
-        free(sym->name);
-        free(sym);
-        sym = next;
+        sym->shadowed = table->free_symbols;
+        table->free_symbols = sym;
     }
 
-    current_scope = old->parent;
-    free(old);
+    table->current_scope = old->parent;
+    old->parent = table->free_scopes;
+    table->free_scopes = old;
 }
 
 // Search only in the current scope
-Symbol* lookup_local(char *name) {
-    if (!current_scope) return NULL;
+Symbol* lookup_local(SymbolTable *table, char *name) {
+    table->lookup_calls++;
+    if (!table->current_scope) return NULL;
 
-    Symbol *sym = current_scope->symbols;
-
-    while (sym) {
-        if (strcmp(sym->name, name) == 0)
-            return sym;
-        sym = sym->next;
-    }
+    Symbol *sym = find_symbol(table, name);
+    if (sym && sym->scope == table->current_scope)
+        return sym;
 
     return NULL;
 }
 
-// Hierarchical search (current scopes -> previous scopes)
-Symbol* lookup(char *name) {
-    Scope *s = current_scope;
-
-    while (s) {
-        Symbol *sym = s->symbols;
-        while (sym) {
-            if (strcmp(sym->name, name) == 0)
-                return sym;
-            sym = sym->next;
-        }
-        s = s->parent;
-    }
+// Hierarchical search (current scopes -> previous scopes): the slot
+// always holds the innermost visible symbol
+Symbol* lookup(SymbolTable *table, char *name) {
+    table->lookup_calls++;
 
-    return NULL;
+    return find_symbol(table, name);
 }
 
-// Insert a new symbol in the current scope
-Symbol* install(char *name, Category cat, Type type, int level) {
-    if (!current_scope) return NULL;
+// Insert a new symbol in the current scope.
+// Returns NULL when the name is already declared in that scope
+Symbol* install(SymbolTable *table, char *name, Category cat, Type type, int level) {
+    table->install_calls++;
+    if (!table->current_scope) return NULL;
 
-    Symbol *exist = lookup_local(name);
-    if (exist) {
-        printf("\nSemantic error: identifier '%s' declared twice in the same scope.\n", name);
-        exit(1);
+    if ((table->count + 1) * 10 > table->capacity * 7) grow_slots(table);
+
+    long probes = 0;
+    SymbolSlot *slot = probe_slot(table, name, &probes);
+    if (!slot->name) {
+        slot->name = name;
+        slot->symbol = NULL;
+        table->count++;
     }
+    if (slot->symbol && slot->symbol->scope == table->current_scope) return NULL;
+
+    Symbol *s = table->free_symbols;
+    if (s)
+        table->free_symbols = s->shadowed;
+    else
+        s = (Symbol*) arenaAlloc(&table->pool, sizeof(Symbol));
 
-    Symbol *s = (Symbol*) malloc(sizeof(Symbol));
-    s->name = strdup(name);
+    s->name = name;
     s->category = cat;
     s->type = type;
     s->level = level;
-    s->next = current_scope->symbols;
+    s->scope = table->current_scope;
+    s->shadowed = slot->symbol;
+    s->signature = NULL;
 
     if (cat == CAT_VAR) {
-        s->offset = current_scope->next_offset++;
+        s->offset = table->current_scope->next_offset++;
     } else {
         s->offset = -1; 
     }
 
-    current_scope->symbols = s;
+    slot->symbol = s;
+
+    if (table->undo_count == table->undo_capacity) {
+        table->undo_capacity = table->undo_capacity ? table->undo_capacity * 2 : 64;
+        table->undo = (Symbol**) realloc(table->undo, table->undo_capacity * sizeof(Symbol*));
+    }
+    table->undo[table->undo_count++] = s;
 
     return s;
 }
-
@@ -1,6 +1,8 @@
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
+#include "arena.h"
+
 // Symbol Types
 typedef enum {
     TYPE_INT,
@@ -18,32 +20,69 @@ typedef enum {
     CAT_PROGRAM
 } Category;
 
+// Subroutine signature, built once when the subroutine is declared so
+// call sites check their arguments without searching the declarations
+typedef struct Signature {
+    int arity;
+    Type *param_types;          // arity entries, in declaration order
+    Type return_type;           // TYPE_VOID for procedures
+    struct SubRotDeclaration *declaration;  // Holds the code label
+    unsigned int subroutine;    // Row of the declaration in the flat layout
+} Signature;
+
 // Symbol Struct
 typedef struct Symbol {
-    char *name;
+    char *name;                 // Interned identifier
     Category category;
     int level;
     Type type;
     int offset;
-    struct Symbol *next;
+    struct Scope *scope;        // Scope that declared the symbol
+    struct Symbol *shadowed;    // Outer symbol with the same name (free list link once left)
+    Signature *signature;       // Functions and procedures only
 } Symbol;
 
 // Scope Struct
 typedef struct Scope {
-    Symbol *symbols;
     struct Scope *parent;
     int next_offset;
     int level;
+    int undo_mark;              // Undo log length when the scope was entered
 } Scope;
 
-// Pointer to current scope
-extern Scope *current_scope;
+// Name slot: the innermost visible symbol of a name, NULL when none
+typedef struct SymbolSlot {
+    char *name;
+    Symbol *symbol;
+} SymbolSlot;
+
+// Symbol Table Struct (one per pass, so compilations do not share state).
+// Names are hashed by address (they are interned) with open addressing;
+// the undo log lists installed symbols in order, so leaving a scope
+// unbinds exactly the symbols it declared.
+typedef struct SymbolTable {
+    Scope *current_scope;
+    SymbolSlot *slots;
+    unsigned capacity;
+    unsigned count;             // Names that have a slot
+    Symbol **undo;
+    int undo_count;
+    int undo_capacity;
+    Arena pool;                 // Symbols and scopes
+    Symbol *free_symbols;       // Symbols and scopes of left scopes, for reuse
+    Scope *free_scopes;
+    long lookup_calls;          // Counters for rascalc --stats
+    long lookup_steps;          // Slots probed while looking up
+    long install_calls;
+} SymbolTable;
 
 // Symbol table management functions
-void enter_scope();
-void leave_scope();
-Symbol* install(char *name, Category cat, Type type, int level);
-Symbol* lookup(char *name);
-Symbol* lookup_local(char *name);
+void init_symbol_table(SymbolTable *table);
+void free_symbol_table(SymbolTable *table);
+void enter_scope(SymbolTable *table);
+void leave_scope(SymbolTable *table);
+Symbol* install(SymbolTable *table, char *name, Category cat, Type type, int level);
+Symbol* lookup(SymbolTable *table, char *name);
+Symbol* lookup_local(SymbolTable *table, char *name);
 
 #endif